@@ -2,7 +2,20 @@
 #include <scgms/rtl/referencedImpl.h>
 #include <scgms/utils/winapi_mapping.h>
 #include <scgms/utils/string_utils.h>
+#include <scgms/rtl/ChainValidation.h>
+#include <scgms/src/binary_chain_configuration.h>
+#if defined(SCGMS_STARTUP_PROFILER)
+#include <scgms/src/startup_profiler.h>
+#endif
+#include <scgms/utils/heap_profiler.h>
 #include <filters/config.h>
+#if defined(SCGMS_CHAIN_TABLES)
+//produced from config.h's ini by tools/compile_chain --tables
+#include <filters/config_tables.h>
+#elif defined(SCGMS_BINARY_CHAIN_CONFIG)
+//produced from config.h's ini by tools/compile_chain
+#include <filters/config_binary.h>
+#endif
 #include "scgms.h"
 
 #if defined(FREERTOS)
@@ -16,8 +29,77 @@ void print(const char * str)
 }
 #endif
 
+#if defined(SCGMS_CONSTEXPR_CHAIN_CONFIG)
+//requires config_data to be declared as a constexpr char array
+static_assert(scgms::Is_Valid_Chain_Ini(config_data), "filters/config.h: malformed chain configuration");
+#endif
+
 scgms::SFilter_Executor Global_Filter_Executor;
 
+static configuration_snapshot_read Snapshot_Read = nullptr;
+static configuration_snapshot_write Snapshot_Write = nullptr;
+
+void set_configuration_snapshot_storage(configuration_snapshot_read read, configuration_snapshot_write write)
+{
+	Snapshot_Read = read;
+	Snapshot_Write = write;
+}
+
+//the snapshot is the binary chain configuration, whose header carries the hash of the ini it was compiled from;
+//Load_From_Binary rejects it, if the firmware's filter descriptors have changed since
+static bool load_configuration_snapshot(scgms::SPersistent_Filter_Chain_Configuration &configuration, const uint64_t source_hash)
+{
+	if (!Snapshot_Read)
+		return false;
+
+	const size_t len = Snapshot_Read(nullptr, 0);
+	if (len == 0)
+		return false;
+
+	std::vector<uint8_t> snapshot(len);
+	if (Snapshot_Read(snapshot.data(), snapshot.size()) != len)
+		return false;
+
+	binary_chain::CReader reader{ snapshot.data(), snapshot.size() };
+	binary_chain::THeader header;
+	if (!binary_chain::Read_Header(reader, header) || (header.source_hash != source_hash))
+		return false;	//the configuration has changed since
+
+	//the snapshot has been validated when stored, so anything reported means that it does not match the firmware's filters anymore
+	refcnt::Swstr_list snapshot_errors = refcnt::Swstr_list{};
+	size_t error_count = 0;
+	const HRESULT rc = configuration->Load_From_Binary(snapshot.data(), snapshot.size(), snapshot_errors.get());
+	snapshot_errors.for_each([&error_count](auto) {error_count++;});
+	if ((rc == S_OK) && (error_count == 0))
+		return true;
+
+	configuration = scgms::SPersistent_Filter_Chain_Configuration{};	//discard whatever has been loaded
+	return false;
+}
+
+static void store_configuration_snapshot(scgms::SPersistent_Filter_Chain_Configuration &configuration, const uint64_t source_hash, const HRESULT load_rc, refcnt::Swstr_list &errors)
+{
+	if (!Snapshot_Write || (load_rc != S_OK))
+		return;
+
+	//only a configuration loaded without any remark is worth the snapshot
+	size_t error_count = 0;
+	errors.for_each([&error_count](auto) {error_count++;});
+	if (error_count > 0)
+		return;
+
+	refcnt::Swstr_list validation_errors = refcnt::Swstr_list{};
+	if (configuration->Validate(validation_errors.get()) != S_OK)
+		return;	//left to be reported, once a filter reads the malformed value
+
+	std::vector<uint8_t> snapshot;
+	if (Compile_Chain_Configuration(configuration.get(), source_hash, snapshot, validation_errors) != S_OK)
+		return;
+
+	if (!Snapshot_Write(snapshot.data(), snapshot.size()))
+		print("Failed to store the configuration snapshot");
+}
+
 const char * get_config_data()
 {
 	return config_data;
@@ -59,11 +141,158 @@ bool create_event(const SCGMSConcept_Event_Data *simple_event)
 	return false;
 }
 
+void report_heap_profile()
+{
+#if defined(SCGMS_HEAP_PROFILER)
+	print("Heap profile:");
+	heap_profiler::Report(print);
+	print("------------------------------------------");
+#endif
+}
+
+static int execute_configuration(scgms::SPersistent_Filter_Chain_Configuration &configuration, refcnt::Swstr_list &errors)
+{
+	print("Filter executor construction:");
+	//embedded targets run headless, hence there is no use for the presentation-only filters
+	refcnt::Swstr_list elided_filters = refcnt::Swstr_list{};
+#if defined(SCGMS_VALIDATE_CHAIN_CONFIG)
+	//parse all the parameter values upfront, including those which no filter reads
+	configuration->Validate(errors.get());
+#endif
+#if defined(SCGMS_PARALLEL_CHAIN_BUILD) && !defined(SCGMS_SINGLE_THREADED_REFCNT)
+	//filters with an independent Configure are configured concurrently
+	const scgms::NExecution_Flags execution_flags = scgms::NExecution_Flags::Elide_Presentation_Only | scgms::NExecution_Flags::Parallel_Build;
+#else
+	const scgms::NExecution_Flags execution_flags = scgms::NExecution_Flags::Elide_Presentation_Only;
+#endif
+	Global_Filter_Executor = scgms::SFilter_Executor{ configuration.get(), execution_flags, nullptr, nullptr, errors, elided_filters };
+#if !defined(SCGMS_VALIDATE_CHAIN_CONFIG)
+	//parameter values are parsed as the filters read them, so look for the malformed ones only when it did not work out
+	if (!Global_Filter_Executor)
+		configuration->Validate(errors.get());
+#endif
+	bool success = true;
+	errors.for_each([&success](auto str) {print("error:");auto newstr = Narrow_WString(str);print(newstr.c_str());success = false;});
+	elided_filters.for_each([](auto str) {auto newstr = Narrow_WString(str);print(newstr.c_str());});
+	print("------------------------------------------");
+
+#if defined(SCGMS_STARTUP_PROFILER)
+	print("Startup profile:");
+	startup_profiler::Report(print);
+	print("------------------------------------------");
+#endif
+	report_heap_profile();
+
+	if(Global_Filter_Executor && success)
+	{
+		print("Filter chain is ready to execute:");
+		print("------------------------------------------");
+	}
+	else
+	{
+		print("Error constructing filter chain");
+		print("------------------------------------------");
+		return -1;
+	}
+
+	return 0;
+}
+
+int build_filter_chain_from_binary(const uint8_t* binary, size_t len)
+{
+	print("Creating SCGMS filter chain from binary configuration");
+	print("------------------------------------------");
+	refcnt::Swstr_list errors = refcnt::Swstr_list{};
+	scgms::SPersistent_Filter_Chain_Configuration configuration{};
+	if (configuration == NULL)
+	{
+		print("Failed to construct SPersistent_Filter_Chain_Configuration");
+		return -1;
+	}
+
+#if defined(SCGMS_STARTUP_PROFILER)
+	startup_profiler::Reset();
+#endif
+	print("Config errors:");
+	configuration->Load_From_Binary(binary, len, errors.get());
+	print("------------------------------------------");
+
+	return execute_configuration(configuration, errors);
+}
+
+int reconfigure_filter_chain(const char* configuration_input)
+{
+	scgms::IReconfigurable_Filter_Executor* reconfigurable = nullptr;
+	if (!Global_Filter_Executor || (Global_Filter_Executor->QueryInterface(&scgms::IID_Reconfigurable_Filter_Executor, reinterpret_cast<void**>(&reconfigurable)) != S_OK))
+		return build_filter_chain(configuration_input);
+
+	print("Reconfiguring SCGMS filter chain");
+	print("------------------------------------------");
+	refcnt::Swstr_list errors = refcnt::Swstr_list{};
+	scgms::SPersistent_Filter_Chain_Configuration configuration{};
+	if (configuration == NULL)
+	{
+		reconfigurable->Release();
+		print("Failed to construct SPersistent_Filter_Chain_Configuration");
+		return -1;
+	}
+
+	//a partially loaded configuration would be diffed as if the skipped filters were removed, so it must not get any further
+	const HRESULT load_rc = configuration->Load_From_Memory(configuration_input, strlen(configuration_input), errors.get());
+	size_t load_error_count = 0;
+	errors.for_each([&load_error_count](auto) {load_error_count++;});
+	const HRESULT rc = (load_rc == S_OK) && (load_error_count == 0) ? reconfigurable->Reconfigure(configuration.get(), errors.get()) : E_INVALIDARG;
+	reconfigurable->Release();
+
+	errors.for_each([](auto str) {print("error:");auto newstr = Narrow_WString(str);print(newstr.c_str());});
+	print(rc == S_OK ? "Filter chain reconfigured" : (rc == S_FALSE ? "Filter chain unchanged" : "Error reconfiguring filter chain"));
+	print("------------------------------------------");
+
+	if (!Succeeded(rc))
+	{
+		//the running chain is kept, unless the full rebuild has failed and left none
+		if (rc == E_ILLEGAL_STATE_CHANGE)
+			Global_Filter_Executor = scgms::SFilter_Executor{};
+		return -1;
+	}
+
+	return 0;
+}
+
+#if defined(SCGMS_CHAIN_TABLES)
+static int build_filter_chain_from_tables(const scgms::TChain_Table* table)
+{
+	print("Creating SCGMS filter chain from config_tables.h");
+	print("------------------------------------------");
+	refcnt::Swstr_list errors = refcnt::Swstr_list{};
+	scgms::SPersistent_Filter_Chain_Configuration configuration{};
+	if (configuration == NULL)
+	{
+		print("Failed to construct SPersistent_Filter_Chain_Configuration");
+		return -1;
+	}
+
+#if defined(SCGMS_STARTUP_PROFILER)
+	startup_profiler::Reset();
+#endif
+	print("Config errors:");
+	configuration->Load_From_Tables(table, errors.get());
+	print("------------------------------------------");
+
+	return execute_configuration(configuration, errors);
+}
+#endif
+
 int build_filter_chain(const char*  configuration_input)
 {
 	const char* config;
 	if(configuration_input == NULL)
 	{
+#if defined(SCGMS_CHAIN_TABLES)
+		return build_filter_chain_from_tables(&config_table);
+#elif defined(SCGMS_BINARY_CHAIN_CONFIG)
+		return build_filter_chain_from_binary(config_binary_data, config_binary_size);
+#endif
 		configuration_input = config_data;
 		print("Creating SCGMS filter chain from config.h");	
 	}
@@ -86,27 +315,28 @@ int build_filter_chain(const char*  configuration_input)
 	print(configuration_input);
 	print("------------------------------------------");
 
-	print("Config errors:");
-	configuration->Load_From_Memory(configuration_input, strlen(configuration_input), errors.get());
-	print("------------------------------------------");
-
-	print("Filter executor construction:");
-	Global_Filter_Executor = scgms::SFilter_Executor{ configuration.get(), nullptr, nullptr, errors };
-	bool success = true;
-	errors.for_each([&success](auto str) {print("error:");auto newstr = Narrow_WString(str);print(newstr.c_str());success = false;});
-	print("------------------------------------------");
-
-	if(Global_Filter_Executor && success)
+#if defined(SCGMS_STARTUP_PROFILER)
+	startup_profiler::Reset();
+#endif
+	const size_t input_len = strlen(configuration_input);
+	const uint64_t source_hash = (Snapshot_Read || Snapshot_Write) ? binary_chain::Hash_Source(configuration_input, input_len) : 0;
+	if (load_configuration_snapshot(configuration, source_hash))
 	{
-		print("Filter chain is ready to execute:");
-		print("------------------------------------------");
+		print("Loaded the configuration snapshot");
 	}
 	else
 	{
-		print("Error constructing filter chain");
-		print("------------------------------------------");
-		return -1;
+		if (configuration == NULL)
+		{
+			print("Failed to construct SPersistent_Filter_Chain_Configuration");
+			return -1;
+		}
+
+		print("Config errors:");
+		const HRESULT load_rc = configuration->Load_From_Memory(configuration_input, input_len, errors.get());
+		store_configuration_snapshot(configuration, source_hash, load_rc, errors);
 	}
+	print("------------------------------------------");
 
-	return 0;
+	return execute_configuration(configuration, errors);
 }
\ No newline at end of file
@@ -22,11 +22,21 @@ typedef struct _SCGMSConcept_Event_Data {
 #ifdef __cplusplus
 extern "C" {
 #endif
+//warm boot - persistent storage of the validated configuration, e.g., a flash partition
+//read copies up to capacity bytes of the stored snapshot into buffer and returns the snapshot's size, 0 if there is none; buffer may be NULL to query the size
+//write replaces the stored snapshot, returns false on failure
+typedef size_t (*configuration_snapshot_read)(uint8_t* buffer, size_t capacity);
+typedef bool (*configuration_snapshot_write)(const uint8_t* snapshot, size_t len);
+
 const char * get_config_data();
+void set_configuration_snapshot_storage(configuration_snapshot_read read, configuration_snapshot_write write);	//NULLs disable the snapshot
 int build_filter_chain(const char* configuration); 
+int build_filter_chain_from_binary(const uint8_t* binary, size_t len);
+int reconfigure_filter_chain(const char* configuration);	//applies the changes against the running chain; builds it, if there is none
 void create_level_event(double level_input);
 void create_shutdown_event();
 bool create_event(const SCGMSConcept_Event_Data *simple_event);
+void report_heap_profile();	//prints the per-tag heap counters, e.g., at shutdown; does nothing unless built with SCGMS_HEAP_PROFILER (or SCGMS_STARTUP_PROFILER)
 #ifdef __cplusplus
 }
 #endif
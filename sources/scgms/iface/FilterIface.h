@@ -41,6 +41,7 @@
 #include <vector>
 
 #include "DeviceIface.h"
+#include "SolverIface.h"
 #include "referencedIface.h"
 #include "../utils/winapi_mapping.h"
 
@@ -105,6 +106,7 @@ namespace scgms {
 
 		//management
 		virtual HRESULT IfaceCalling Clone(scgms::IFilter_Parameter **deep_copy) = 0;
+		virtual HRESULT IfaceCalling Validate() = 0;	//parses the text loaded, but not read yet; S_OK if it is a valid value of the parameter's type
 	};
 	
 
@@ -117,6 +119,15 @@ namespace scgms {
 		virtual HRESULT IfaceCalling Set_Variable(const wchar_t* name, const wchar_t* value) = 0;	
 	};
 
+	//{912C71FC-F9DE-48FB-B0DB-B4DBABC46F3B}
+	constexpr GUID IID_Filter_Configuration_Index = { 0x912c71fc, 0xf9de, 0x48fb, { 0xb0, 0xdb, 0xb4, 0xdb, 0xab, 0xc4, 0x6f, 0x3b } };
+	class IFilter_Configuration_Index : public virtual refcnt::IReferenced {
+	public:
+			//returns a non-owning pointer to the last parameter of the given config name, valid as long as the configuration is not modified
+			//S_FALSE and nullptr, if there is no such parameter
+		virtual HRESULT IfaceCalling Find_Parameter(const wchar_t* config_name, scgms::IFilter_Parameter** parameter) = 0;
+	};
+
 	class IFilter_Chain_Configuration : public virtual refcnt::IVector_Container<IFilter_Configuration_Link*> {
 	public:
 		//virtual HRESULT IfaceCalling Get_Parent_Path(refcnt::wstr_container** path) = 0;
@@ -125,11 +136,48 @@ namespace scgms {
 		virtual HRESULT IfaceCalling Set_Variable(const wchar_t* name, const wchar_t* value) = 0;	//setting value to nullptr erases the variable
 	};
 
+	//how a precompiled parameter stores its value; only the arrays with nested variables are kept as text
+	enum class NParameter_Value_Encoding : uint8_t {
+		Value = 0,
+		Variable,		//the whole value is $(variable_name)
+		Text
+	};
+
+	//ROM-resident chain configuration, as generated by tools/compile_chain; all the pointers must outlive the loaded configuration
+	struct TParameter_Entry {
+		uint16_t descriptor_index;			//into the parameters of the link's filter descriptor
+		NParameter_Type type;
+		NParameter_Value_Encoding encoding;
+		double dbl;							//ptDouble, ptRatTime
+		int64_t int64;						//ptInt64, ptSubject_Id, ptBool
+		GUID guid;							//GUID-typed parameters
+		const wchar_t *str;					//ptWChar_Array, variable name or text
+		const double *dbl_array;			//ptDouble_Array
+		const int64_t *int64_array;			//ptInt64_Array
+		size_t count;						//of the array
+	};
+
+	struct TLink_Entry {
+		GUID filter_id;
+		const TParameter_Entry *parameters;
+		size_t parameters_count;
+	};
+
+	struct TChain_Table {
+		const TLink_Entry *links;
+		size_t links_count;
+		uint64_t source_hash;				//of the ini the table was generated from
+	};
+
 	class IPersistent_Filter_Chain_Configuration : public virtual IFilter_Chain_Configuration {
 	public:
 			//both Load_From_ methods returns S_FALSE if incomplete configuration was constructed
 		//virtual HRESULT IfaceCalling Load_From_File(const wchar_t *file_path, refcnt::wstr_list* error_description) = 0;	//file_path cannot be nullptr
 		virtual HRESULT IfaceCalling Load_From_Memory(const char *memory, const size_t len, refcnt::wstr_list* error_description) = 0;	//resets internal file path to nullptr
+		virtual HRESULT IfaceCalling Load_From_Binary(const uint8_t *binary, const size_t len, refcnt::wstr_list* error_description) = 0;	//binary produced by Compile_Chain_Configuration
+		virtual HRESULT IfaceCalling Load_From_Tables(const TChain_Table *table, refcnt::wstr_list* error_description) = 0;
+		//Load_From_Memory defers parsing of the parameter values until they are read, this reports the malformed ones; returns S_FALSE if there are any
+		virtual HRESULT IfaceCalling Validate(refcnt::wstr_list* error_description) = 0;
 		//virtual HRESULT IfaceCalling Save_To_File(const wchar_t *file_path, refcnt::wstr_list* error_description) = 0; //if nullptr, saves to the file_name previously supplied to Load_From_File		
 																				 //=> cannot be called with file_path==nullptr after Load_From_Memory only, returns E_ILLEGAL_METHOD_CALL then
 	};	
@@ -154,6 +202,34 @@ namespace scgms {
 		virtual HRESULT IfaceCalling Terminate(const BOOL wait_for_shutdown) = 0;	
 	};
 	
+	enum class NExecution_Flags : uint32_t {
+		None = 0,
+		Elide_Presentation_Only = 1 << 0,	//headless profile - filters flagged as NFilter_Flags::Presentation_Only are not instantiated at all
+		Parallel_Build = 1 << 1,			//filters flagged as NFilter_Flags::Independent_Configure are constructed and configured concurrently, on platforms with threads
+	};
+
+	using TExecution_Flags = std::underlying_type<NExecution_Flags>::type;
+
+	inline NExecution_Flags operator|(const NExecution_Flags lhs, const NExecution_Flags rhs) {
+		return static_cast<NExecution_Flags>(static_cast<TExecution_Flags>(lhs) | static_cast<TExecution_Flags>(rhs));
+	}
+
+	inline NExecution_Flags operator&(const NExecution_Flags lhs, const NExecution_Flags rhs) {
+		return static_cast<NExecution_Flags>(static_cast<TExecution_Flags>(lhs) & static_cast<TExecution_Flags>(rhs));
+	}
+
+	//{3F9EF309-6E7F-470F-B95A-CC94016B09C7}
+	constexpr GUID IID_Reconfigurable_Filter_Executor = { 0x3f9ef309, 0x6e7f, 0x470f, { 0xb9, 0x5a, 0xcc, 0x94, 0x1, 0x6b, 0x9, 0xc7 } };
+	class IReconfigurable_Filter_Executor : public virtual IFilter_Executor {
+	public:
+			//diffs the configuration against the running one - filters with changed parameters are re-configured,
+			//only the filters in between the unchanged beginning and end of the chain get (re)created
+			//returns S_FALSE if nothing has changed; on failure, the running chain is kept as it was, except when
+			//	- a filter refuses its well-formed parameters in-place; the chain keeps running with the changes applied so far
+			//	- E_ILLEGAL_STATE_CHANGE, when the full rebuild (feedback filters involved) has failed and left no chain running
+		virtual HRESULT IfaceCalling Reconfigure(IFilter_Chain_Configuration *configuration, refcnt::wstr_list *error_description) = 0;
+	};
+
 	class IFilter_Feedback : public virtual scgms::IFilter {
 	public:
 		virtual HRESULT IfaceCalling Name(wchar_t** const name) = 0;
@@ -180,9 +256,19 @@ namespace scgms {
 	using TCreate_Filter = HRESULT(IfaceCalling *)(const GUID *id, IFilter *next_filter, scgms::IFilter **filter);
 	using TOn_Filter_Created = HRESULT(IfaceCalling *)(scgms::IFilter *filter, const void* data);
 	using TExecute_Filter_Configuration = HRESULT(IfaceCalling*)(IFilter_Chain_Configuration *configuration, scgms::TOn_Filter_Created on_filter_created, const void* on_filter_created_data, scgms::IFilter *output, scgms::IFilter_Executor **executor, refcnt::wstr_list *error_description);
+	//elided_filters receives the description of each filter, which was not instantiated due to the execution_flags; it can be nullptr
+	using TExecute_Filter_Configuration_Ex = HRESULT(IfaceCalling*)(IFilter_Chain_Configuration *configuration, const scgms::NExecution_Flags execution_flags, scgms::TOn_Filter_Created on_filter_created, const void* on_filter_created_data, scgms::IFilter *output, scgms::IFilter_Executor **executor, refcnt::wstr_list *error_description, refcnt::wstr_list *elided_filters);
+	//instantiates the chain shard_count times and routes the events by their segment_id; zero shard_count selects the hardware concurrency
+	using TExecute_Sharded_Filter_Configuration = HRESULT(IfaceCalling*)(IFilter_Chain_Configuration *configuration, const size_t shard_count, const scgms::NExecution_Flags execution_flags, scgms::TOn_Filter_Created on_filter_created, const void* on_filter_created_data, scgms::IFilter *output, scgms::IFilter_Executor **executor, refcnt::wstr_list *error_description, refcnt::wstr_list *elided_filters);
 	using TCreate_Filter_Parameter = HRESULT(IfaceCalling*)(const scgms::NParameter_Type type, const wchar_t *config_name, scgms::IFilter_Parameter **parameter);
 	using TCreate_Filter_Configuration_Link = HRESULT(IfaceCalling*)(const GUID *filter_id, scgms::IFilter_Configuration_Link **link);
 	using TCreate_Discrete_Model = HRESULT(IfaceCalling*)(const GUID *model_id, scgms::IModel_Parameter_Vector *parameters, scgms::IFilter *output, scgms::IDiscrete_Model **model);
+	using TOptimize_Parameters = HRESULT(IfaceCalling*)(scgms::IFilter_Chain_Configuration *configuration, const size_t filter_index, const wchar_t *parameters_configuration_name,
+		scgms::TOn_Filter_Created on_filter_created, const void* on_filter_created_data, const GUID *solver_id, const size_t population_size, const size_t max_generations,
+		solver::TSolver_Progress *progress, refcnt::wstr_list *error_description);
+	using TOptimize_Multiple_Parameters = HRESULT(IfaceCalling*)(scgms::IFilter_Chain_Configuration *configuration, const size_t *filter_indices, const wchar_t **parameters_configuration_names, const size_t filter_count,
+		scgms::TOn_Filter_Created on_filter_created, const void* on_filter_created_data, const GUID *solver_id, const size_t population_size, const size_t max_generations,
+		solver::TSolver_Progress *progress, refcnt::wstr_list *error_description);
 
 	//The following GUIDs advertise known filters 		
 	constexpr GUID IID_Drawing_Filter = { 0x850a122c, 0x8943, 0xa211,{ 0xc5, 0x14, 0x25, 0xba, 0xa9, 0x14, 0x35, 0x74 } };
@@ -0,0 +1,59 @@
+/**
+ * SmartCGMS - continuous glucose monitoring and controlling framework
+ * https://diabetes.zcu.cz/
+ *
+ * Copyright (c) since 2018 University of West Bohemia.
+ *
+ * Contact:
+ * diabetes@mail.kiv.zcu.cz
+ * Medical Informatics, Department of Computer Science and Engineering
+ * Faculty of Applied Sciences, University of West Bohemia
+ * Univerzitni 8, 301 00 Pilsen
+ * Czech Republic
+ * 
+ * 
+ * Purpose of this software:
+ * This software is intended to demonstrate work of the diabetes.zcu.cz research
+ * group to other scientists, to complement our published papers. It is strictly
+ * prohibited to use this software for diagnosis or treatment of any medical condition,
+ * without obtaining all required approvals from respective regulatory bodies.
+ *
+ * Especially, a diabetic patient is warned that unauthorized use of this software
+ * may result into severe injure, including death.
+ *
+ *
+ * Licensing terms:
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * a) This file is available under the Apache License, Version 2.0.
+ * b) When publishing any derivative work or results obtained using this software, you agree to cite the following paper:
+ *    Tomas Koutny and Martin Ubl, "SmartCGMS as a Testbed for a Blood-Glucose Level Prediction and/or 
+ *    Control Challenge with (an FDA-Accepted) Diabetic Patient Simulation", Procedia Computer Science,  
+ *    Volume 177, pp. 354-362, 2020
+ */
+
+#pragma once
+
+#include "referencedIface.h"
+#include "../utils/winapi_mapping.h"
+
+#include <cstddef>
+#include <array>
+
+namespace solver {
+
+	//the layout of the desktop SmartCGMS, so that its tooling reads the progress as is
+	constexpr size_t Maximum_Objectives_Count = 10;
+	using TFitness = std::array<double, Maximum_Objectives_Count>;
+
+	struct TSolver_Progress {
+		size_t current_progress;	//set by solver, counts the generations evaluated so far
+		size_t max_progress;		//set by solver, zero means unknown
+		TFitness best_metric;		//best metric found so far; set by solver - the local optimizer has the first objective only
+		BOOL cancelled;				//set by user to cancel the solver; the solver returns the best solution found so far
+	};
+
+	constexpr TSolver_Progress Null_Solver_Progress = { 0, 0, TFitness{}, FALSE };
+}
@@ -45,6 +45,7 @@ namespace scgms {
 		None = 0,
 		Encapsulated_Model = 1 << 0,		// the filter itself defines a model with the same GUID
 		Presentation_Only = 1 << 1,			// the filter is used only during a presentation phase, i.e. it does not get instantiated during parameters optimalization and similar processes
+		Independent_Configure = 1 << 2,		// Configure neither sends events, nor starts anything that would, nor depends on the other filters - the filter can be configured concurrently with them
 	};
 
 	using TFilter_Flags = std::underlying_type<NFilter_Flags>::type;
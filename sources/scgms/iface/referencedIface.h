@@ -43,6 +43,7 @@
 #endif
 
 #include <memory>
+#include <type_traits>
 
 #include "../rtl/hresult.h"
 #include "../rtl/guid.h"
@@ -71,14 +72,40 @@ namespace refcnt {
 		virtual ULONG IfaceCalling Release() = 0;
 	};
 
+	namespace internal {
+		//S either extends std::shared_ptr<I>, or the intrusive SReferenced<I>
+		template <typename S, typename I>
+		constexpr bool Is_Shared_Ptr_Reference = std::is_base_of<std::shared_ptr<I>, S>::value;
+
+		//target takes over the obj's reference
+		template <typename S, typename I>
+		void Attach_Reference(S &target, I *obj) {
+			if constexpr (Is_Shared_Ptr_Reference<S, I>)
+				target.reset(obj, [](I* obj_to_release) {if (obj_to_release != nullptr) obj_to_release->Release(); });
+				//shared_ptr will overtake the assignment operations and maintain its own counter
+				//when shared_ptr's counter comes to zero, referenced's Release  takes action
+			else
+				target.attach(obj);
+		}
+	}
+
 	template <typename S, typename I>
-	//this one is designed for extending std::shared_ptr via inheritance
+	//this one is designed for extending SReferenced, or std::shared_ptr, via inheritance
 	S make_shared_reference_ext(I *obj, bool add_reference) {
 		if ((add_reference) && (obj != nullptr)) obj->AddRef();
 		S result;
-		result.reset(obj, [](I* obj_to_release) {if (obj_to_release != nullptr) obj_to_release->Release(); });
-		//shared_ptr will overtake the assignment operations and maintain its own counter
-		//when shared_ptr's counter comes to zero, referenced's Release  takes action
+		internal::Attach_Reference<S, I>(result, obj);
+		return result;
+	}
+
+	//non-owning reference, which does not add_ref; the caller guarantees the obj's lifetime
+	template <typename S, typename I>
+	S make_borrowed_reference_ext(I *obj) {
+		S result;
+		if constexpr (internal::Is_Shared_Ptr_Reference<S, I>)
+			static_cast<std::shared_ptr<I>&>(result) = std::shared_ptr<I>{ std::shared_ptr<I>{}, obj };	//aliasing an empty owner
+		else
+			result.borrow(obj);
 		return result;
 	}
 
@@ -87,11 +114,11 @@ namespace refcnt {
 		return make_shared_reference_ext<std::shared_ptr<I>, I>(obj, add_reference);
 	}
 
-	template <typename I, typename Q>
-	void Query_Interface(I *obj, const GUID &id, std::shared_ptr<Q> &target) {
+	template <typename I, typename Q, typename S>
+	void Query_Interface(I *obj, const GUID &id, S &target) {
 		Q* queried;
 		if (obj->QueryInterface(&id, reinterpret_cast<void**>(&queried)) == S_OK)
-			target.reset(queried, [](Q* obj_to_release) { if (obj_to_release != nullptr) obj_to_release->Release(); });
+			internal::Attach_Reference<S, Q>(target, queried);
 	}
 
 	template <typename T>
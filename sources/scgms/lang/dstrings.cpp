@@ -920,6 +920,13 @@ const wchar_t* dsCannot_read_filter_id = L"Cannot read filter id.";
 const wchar_t* dsFailed_to_configure_filter = L"Failed to configure filter with id: ";
 const wchar_t* dsLast_RC = L"Error code: ";
 const wchar_t* dsFeedback_sender_not_connected = L"Feedback-sender not connected, sender's name: ";
+const wchar_t* dsPresentation_Only_Filter_Elided = L"Presentation-only filter elided, id: ";
+const wchar_t* dsFailed_to_build_shard = L"Failed to build the filter chain of shard: ";
+const wchar_t* dsMalformed_Binary_Chain_Configuration = L"Malformed or incompatible binary chain configuration, offset: ";
+const wchar_t* dsBinary_Chain_Parameter_Mismatch = L"Binary chain configuration does not match the filter descriptor, recompile it. Filter(1)-parameter index(2): (1)";
+const wchar_t* dsBinary_Chain_Filters_Mismatch = L"Binary chain configuration has been compiled with different filter descriptors, recompile it.";
+const wchar_t* dsParameter_Schema_Mismatch = L"Parameter schema does not match the filter descriptor. Filter(1)-parameter(2): (1)";
+const wchar_t* dsRequired_Filter_Parameter_Not_Configured = L"Required filter(1)-parameter(2) is not configured: (1)";
 const wchar_t* dsFilter_configuration_param_value_error = L"Filter(1)-parameter(2) value(3) error: (1)";
 const wchar_t* dsStored_Parameters_Corrupted_Not_Loaded = L"Stored parameters are corruped and were not loaded.";
 
@@ -922,6 +922,13 @@ extern const wchar_t* dsCannot_read_filter_id;
 extern const wchar_t* dsFailed_to_configure_filter;
 extern const wchar_t* dsLast_RC;
 extern const wchar_t* dsFeedback_sender_not_connected;
+extern const wchar_t* dsPresentation_Only_Filter_Elided;
+extern const wchar_t* dsFailed_to_build_shard;
+extern const wchar_t* dsMalformed_Binary_Chain_Configuration;
+extern const wchar_t* dsBinary_Chain_Parameter_Mismatch;
+extern const wchar_t* dsBinary_Chain_Filters_Mismatch;
+extern const wchar_t* dsParameter_Schema_Mismatch;
+extern const wchar_t* dsRequired_Filter_Parameter_Not_Configured;
 extern const wchar_t* dsFilter_configuration_param_value_error;
 extern const wchar_t* dsStored_Parameters_Corrupted_Not_Loaded;
 
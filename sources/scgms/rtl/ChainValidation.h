@@ -0,0 +1,145 @@
+/**
+ * SmartCGMS - continuous glucose monitoring and controlling framework
+ * https://diabetes.zcu.cz/
+ *
+ * Copyright (c) since 2018 University of West Bohemia.
+ *
+ * Contact:
+ * diabetes@mail.kiv.zcu.cz
+ * Medical Informatics, Department of Computer Science and Engineering
+ * Faculty of Applied Sciences, University of West Bohemia
+ * Univerzitni 8, 301 00 Pilsen
+ * Czech Republic
+ * 
+ * 
+ * Purpose of this software:
+ * This software is intended to demonstrate work of the diabetes.zcu.cz research
+ * group to other scientists, to complement our published papers. It is strictly
+ * prohibited to use this software for diagnosis or treatment of any medical condition,
+ * without obtaining all required approvals from respective regulatory bodies.
+ *
+ * Especially, a diabetic patient is warned that unauthorized use of this software
+ * may result into severe injure, including death.
+ *
+ *
+ * Licensing terms:
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * a) This file is available under the Apache License, Version 2.0.
+ * b) When publishing any derivative work or results obtained using this software, you agree to cite the following paper:
+ *    Tomas Koutny and Martin Ubl, "SmartCGMS as a Testbed for a Blood-Glucose Level Prediction and/or 
+ *    Control Challenge with (an FDA-Accepted) Diabetic Patient Simulation", Procedia Computer Science,  
+ *    Volume 177, pp. 354-362, 2020
+ */
+
+#pragma once
+
+#include <cstddef>
+
+//Compile-time syntax check of a chain configuration ini, so that a malformed config.h fails the build rather than the boot:
+//	static_assert(scgms::Is_Valid_Chain_Ini(config_data), "malformed chain configuration");
+//which requires config_data to be a constexpr char array. It checks the layout of the sections, filter ids and key-value lines,
+//but not the filter descriptors, which are not known at compile time - tools/compile_chain does that.
+namespace scgms {
+
+	namespace chain_validation {
+
+		constexpr bool Is_Blank(const char c) {
+			return (c == ' ') || (c == '\t') || (c == '\r');
+		}
+
+		constexpr bool Is_Hex(const char c) {
+			return ((c >= '0') && (c <= '9')) || ((c >= 'a') && (c <= 'f')) || ((c >= 'A') && (c <= 'F'));
+		}
+
+		//xxxxxxxx-xxxx-xxxx-xxxx-xxxxxxxxxxxx, optionally in curly brackets as WString_To_GUID accepts it
+		constexpr bool Is_GUID(const char *begin, const char *end) {
+			if ((end - begin) == 38) {
+				if ((begin[0] != '{') || (begin[37] != '}')) return false;
+				begin++;
+				end--;
+			}
+
+			if ((end - begin) != 36) return false;
+
+			for (size_t i = 0; i < 36; i++) {
+				const bool is_dash_position = (i == 8) || (i == 13) || (i == 18) || (i == 23);
+				if (is_dash_position ? (begin[i] != '-') : !Is_Hex(begin[i]))
+					return false;
+			}
+
+			return true;
+		}
+
+		//the part between the brackets; Filter_{id} or Filter_anything_{id} as Load_From_Memory accepts them
+		constexpr bool Is_Filter_Section(const char *begin, const char *end) {
+			const char prefix[] = "Filter_";
+			for (size_t i = 0; i < sizeof(prefix) - 1; i++) {
+				if ((begin + i >= end) || (begin[i] != prefix[i]))
+					return false;
+			}
+
+			const char *id = begin + sizeof(prefix) - 1;
+			for (const char *iter = id; iter < end; iter++) {
+				if (*iter == '_') {
+					id = iter + 1;
+					break;
+				}
+			}
+
+			return Is_GUID(id, end);
+		}
+
+		constexpr bool Is_Valid_Line(const char *begin, const char *end, bool &in_section) {
+			while ((begin < end) && Is_Blank(*begin)) begin++;
+			while ((end > begin) && Is_Blank(*(end - 1))) end--;
+
+			if ((begin == end) || (*begin == ';') || (*begin == '#'))
+				return true;
+
+			if (*begin == '[') {
+				if (*(end - 1) != ']')
+					return false;
+				in_section = true;
+				return Is_Filter_Section(begin + 1, end - 1);
+			}
+
+			//key = value, which has to belong to a section
+			if (!in_section || (*begin == '='))
+				return false;
+			for (const char *iter = begin; iter < end; iter++) {
+				if (*iter == '=')
+					return true;
+			}
+
+			return false;
+		}
+	}
+
+	//returns zero for a valid configuration, or the 1-based number of the first malformed line
+	constexpr size_t Find_Chain_Ini_Error(const char *ini) {
+		bool in_section = false;
+		size_t line_number = 1;
+		const char *line = ini;
+
+		for (const char *iter = ini; ; iter++) {
+			if ((*iter == '\n') || (*iter == 0)) {
+				if (!chain_validation::Is_Valid_Line(line, iter, in_section))
+					return line_number;
+				if (*iter == 0)
+					break;
+
+				line = iter + 1;
+				line_number++;
+			}
+		}
+
+		return 0;
+	}
+
+	constexpr bool Is_Valid_Chain_Ini(const char *ini) {
+		return Find_Chain_Ini_Error(ini) == 0;
+	}
+}
@@ -53,7 +53,7 @@ bool scgms::SModel_Parameter_Vector::set(const std::vector<double> &params) {
 	double *data_ptr = const_cast<double*>(params.data());
 	if (!operator bool()) {
 		scgms::IModel_Parameter_Vector *new_vector = refcnt::Create_Container<double>(data_ptr, data_ptr + params.size());
-		reset(new_vector, [](scgms::IModel_Parameter_Vector* obj_to_release) { if (obj_to_release != nullptr) obj_to_release->Release(); });
+		attach(new_vector);
 		return operator bool();
 	} else
 		return get()->set(data_ptr, data_ptr + params.size()) == S_OK;
@@ -68,7 +68,7 @@ bool scgms::SModel_Parameter_Vector::set(const scgms::SModel_Parameter_Vector &p
 
 	if (!operator bool()) {
 		scgms::IModel_Parameter_Vector *new_vector = refcnt::Create_Container<double>(begin, end);
-		reset(new_vector, [](scgms::IModel_Parameter_Vector* obj_to_release) { if (obj_to_release != nullptr) obj_to_release->Release(); });
+		attach(new_vector);
 		return operator bool();
 	} else
 		return get()->set(begin, end) == S_OK;
@@ -87,7 +87,7 @@ scgms::SSignal::SSignal(scgms::STime_Segment segment, const GUID &signal_id) :
 scgms::SSignal::SSignal(scgms::STime_Segment segment, const GUID& signal_id, const GUID& approx_id) {
 	scgms::ISignal* signal;
 	if (imported::create_signal_external(&signal_id, segment.get(), approx_id == Invalid_GUID ? nullptr : &approx_id, &signal) == S_OK) {
-		reset(signal, [](scgms::ISignal* obj_to_release) { if (obj_to_release != nullptr) obj_to_release->Release(); });
+		attach(signal);
 	}
 }
 
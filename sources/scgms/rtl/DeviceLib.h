@@ -46,7 +46,7 @@
 
 namespace scgms {
 
-	class SModel_Parameter_Vector : public std::shared_ptr<IModel_Parameter_Vector> {
+	class SModel_Parameter_Vector : public virtual refcnt::SReferenced<IModel_Parameter_Vector> {
 	public:
 		bool set(const std::vector<double> &params);
 		bool set(const SModel_Parameter_Vector &params);
@@ -55,7 +55,7 @@ namespace scgms {
 
 	class STime_Segment;
 
-	class SSignal : public std::shared_ptr<ISignal> {
+	class SSignal : public virtual refcnt::SReferenced<ISignal> {
 	public:
 		SSignal() {};	//just an empty object
 		SSignal(STime_Segment segment, const GUID &signal_id);
@@ -83,7 +83,7 @@ namespace scgms {
 		SSignal Get_Signal(const GUID &signal_id);
 	};
 
-	class STime_Segment : public std::shared_ptr<ITime_Segment> {
+	class STime_Segment : public virtual refcnt::SReferenced<ITime_Segment> {
 	public:
 		SSignal Get_Signal(const GUID &signal_id);
 	};
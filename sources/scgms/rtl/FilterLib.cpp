@@ -40,6 +40,7 @@
 #include "UILib.h"
 #endif
 #include "../utils/string_utils.h"
+#include "../utils/descriptor_utils.h"
 
 
 #include <wchar.h>
@@ -54,6 +55,7 @@ namespace scgms {
 			scgms::TGet_Filter_Descriptors get_filter_descriptors_external = scgms::factory::resolve_symbol<scgms::TGet_Filter_Descriptors>("get_filter_descriptors");
 			scgms::TCreate_Persistent_Filter_Chain_Configuration create_persistent_filter_chain_configuration_external = scgms::factory::resolve_symbol<scgms::TCreate_Persistent_Filter_Chain_Configuration>("create_persistent_filter_chain_configuration");
 			scgms::TExecute_Filter_Configuration execute_filter_configuration_external = scgms::factory::resolve_symbol<scgms::TExecute_Filter_Configuration>("execute_filter_configuration");
+			scgms::TExecute_Filter_Configuration_Ex execute_filter_configuration_ex_external = scgms::factory::resolve_symbol<scgms::TExecute_Filter_Configuration_Ex>("execute_filter_configuration_ex");
 			scgms::TCreate_Filter_Parameter create_filter_parameter_external = scgms::factory::resolve_symbol<scgms::TCreate_Filter_Parameter>("create_filter_parameter");
 			scgms::TCreate_Filter_Configuration_Link create_filter_configuration_link_external = scgms::factory::resolve_symbol<scgms::TCreate_Filter_Configuration_Link>("create_filter_configuration_link");
 			scgms::TCreate_Discrete_Model create_discrete_model_external = scgms::factory::resolve_symbol<scgms::TCreate_Discrete_Model>("create_discrete_model");
@@ -106,7 +108,7 @@ namespace scgms {
 	}
 
 	HRESULT SFilter_Parameter::set_wstring(const wchar_t *str) {
-		std::shared_ptr<refcnt::wstr_container> wstr = refcnt::WString_To_WChar_Container_shared(str);
+		refcnt::SReferenced<refcnt::wstr_container> wstr = refcnt::WString_To_WChar_Container_shared(str);
 		return get()->Set_WChar_Container(wstr.get());
 	}
 
@@ -247,7 +249,7 @@ namespace scgms {
 	SPersistent_Filter_Chain_Configuration::SPersistent_Filter_Chain_Configuration() {
 		IPersistent_Filter_Chain_Configuration *configuration;
 		if (imported::create_persistent_filter_chain_configuration_external(&configuration) == S_OK)
-			reset(configuration, [](IPersistent_Filter_Chain_Configuration* obj_to_release) { if (obj_to_release != nullptr) obj_to_release->Release(); });
+			attach(configuration);
 	}
 
 
@@ -256,7 +258,7 @@ namespace scgms {
 
 		if (operator bool()) {
 			scgms::IFilter_Chain_Configuration* raw = get();
-			result.reset(raw, [](IFilter_Chain_Configuration *obj_to_release) { if (obj_to_release != nullptr) obj_to_release->Release(); });
+			result.attach(raw);
 			raw->AddRef();
 		}
 
@@ -267,7 +269,13 @@ namespace scgms {
 	SFilter_Executor::SFilter_Executor(refcnt::SReferenced<scgms::IFilter_Chain_Configuration> configuration, scgms::TOn_Filter_Created on_filter_created, const void* on_filter_created_data, refcnt::Swstr_list error_description, scgms::IFilter *output) {
 		scgms::IFilter_Executor *executor;
 		if (Succeeded(imported::execute_filter_configuration_external(configuration.get(), on_filter_created, on_filter_created_data, output, &executor, error_description.get())))
-			reset(executor, [](scgms::IFilter_Executor* obj_to_release) { if (obj_to_release != nullptr) obj_to_release->Release(); });
+			attach(executor);
+	}
+
+	SFilter_Executor::SFilter_Executor(refcnt::SReferenced<scgms::IFilter_Chain_Configuration> configuration, const scgms::NExecution_Flags execution_flags, scgms::TOn_Filter_Created on_filter_created, const void* on_filter_created_data, refcnt::Swstr_list error_description, refcnt::Swstr_list elided_filters, scgms::IFilter *output) {
+		scgms::IFilter_Executor *executor;
+		if (Succeeded(imported::execute_filter_configuration_ex_external(configuration.get(), execution_flags, on_filter_created, on_filter_created_data, output, &executor, error_description.get(), elided_filters.get())))
+			attach(executor);
 	}
 
 
@@ -288,22 +296,35 @@ namespace scgms {
 		return result;
 	}
 
-	bool get_filter_descriptor_by_id(const GUID &id, TFilter_Descriptor &desc) {
-		TFilter_Descriptor *desc_begin, *desc_end;
+	namespace {
+		//the descriptors are static data of the filters, so the index is built just once
+		const CDescriptor_Index<TFilter_Descriptor>& Filter_Descriptor_Index() {
+			static const CDescriptor_Index<TFilter_Descriptor> index = []() {
+				TFilter_Descriptor *desc_begin = nullptr, *desc_end = nullptr;
+				if (imported::get_filter_descriptors_external(&desc_begin, &desc_end) != S_OK)
+					desc_begin = desc_end = nullptr;
+				return CDescriptor_Index<TFilter_Descriptor>{ desc_begin, desc_end };
+			}();
 
-		bool result = imported::get_filter_descriptors_external(&desc_begin, &desc_end) == S_OK;
-		if (result) {
-			result = false;	//we have to find the filter yet
-			for (auto iter = desc_begin; iter != desc_end; iter++)
-				if (iter->id == id) {
-					//desc = *iter;							assign const won't work with const members and custom operator= will result into undefined behavior as it has const members (so it does not have to be const itself)
-					memcpy(&desc, iter, sizeof(decltype(desc)));	//=> memcpy https://stackoverflow.com/questions/9218454/struct-with-const-member
-					result = true;
-					break;
-				}
+			return index;
 		}
 
-		return result;
+		bool Copy_Filter_Descriptor(const TFilter_Descriptor *found, TFilter_Descriptor &desc) {
+			if (!found)
+				return false;
+
+			//desc = *found;							assign const won't work with const members and custom operator= will result into undefined behavior as it has const members (so it does not have to be const itself)
+			memcpy(&desc, found, sizeof(decltype(desc)));	//=> memcpy https://stackoverflow.com/questions/9218454/struct-with-const-member
+			return true;
+		}
+	}
+
+	bool get_filter_descriptor_by_id(const GUID &id, TFilter_Descriptor &desc) {
+		return Copy_Filter_Descriptor(Filter_Descriptor_Index().Find_By_Id(id), desc);
+	}
+
+	bool get_filter_descriptor_by_description(const wchar_t *description, TFilter_Descriptor &desc) {
+		return Copy_Filter_Descriptor(Filter_Descriptor_Index().Find_By_Description(description), desc);
 	}
 
 	
@@ -371,7 +392,7 @@ namespace scgms {
 
 		scgms::IDiscrete_Model *model;
 		if (imported::create_discrete_model_external(&id, parameters_shared.get(), output.get(), &model) == S_OK)
-			reset(model, [](scgms::IDiscrete_Model* obj_to_release) { if (obj_to_release != nullptr) obj_to_release->Release(); });
+			attach(model);
 	}
 	
 	SDrawing_Filter_Inspection::SDrawing_Filter_Inspection(const SFilter &drawing_filter) {
@@ -389,13 +410,13 @@ namespace scgms {
 			refcnt::Query_Interface<scgms::IFilter, scgms::ILog_Filter_Inspection>(log_filter.get(), IID_Log_Filter_Inspection, *this);
 	}
 
-	bool SLog_Filter_Inspection::pop(std::shared_ptr<refcnt::wstr_list> &list) {
+	bool SLog_Filter_Inspection::pop(refcnt::SReferenced<refcnt::wstr_list> &list) {
 		bool result = false;
 		auto ptr_get = get();
 		if (ptr_get) {
 			refcnt::wstr_list *raw_list;
 			if (ptr_get->Pop(&raw_list) == S_OK) {
-				list = refcnt::make_shared_reference<refcnt::wstr_list>(raw_list, false);
+				list = refcnt::make_shared_reference_ext<refcnt::SReferenced<refcnt::wstr_list>, refcnt::wstr_list>(raw_list, false);
 				result = list.operator bool();
 			}
 		}
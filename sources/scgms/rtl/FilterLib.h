@@ -86,6 +86,7 @@ namespace scgms {
 
 	std::vector<TFilter_Descriptor> get_filter_descriptor_list();
 	bool get_filter_descriptor_by_id(const GUID &id, TFilter_Descriptor &desc);
+	bool get_filter_descriptor_by_description(const wchar_t *description, TFilter_Descriptor &desc);
 
 
 	namespace internal {
@@ -97,8 +98,11 @@ namespace scgms {
 		protected:
 			template <typename T, typename M, typename... TArgs>
 			T Read_Parameter(const wchar_t *name, M method, T default_value, TArgs... args) const {				
-				SFilter_Parameter parameter = Resolve_Parameter(name);
-				if (!parameter) return default_value;
+				scgms::IFilter_Parameter* raw_parameter = Find_Parameter(name);
+				if (!raw_parameter) return default_value;
+
+				//the configuration outlives this call, so that there is no need to add_ref
+				SFilter_Parameter parameter = refcnt::make_borrowed_reference_ext<SFilter_Parameter, scgms::IFilter_Parameter>(raw_parameter);
 				
 				HRESULT rc = E_FAIL;
 				T value = ((&parameter)->*method)(rc, args...);
@@ -151,7 +155,7 @@ namespace scgms {
 
 				bool success = false;
 
-				const auto parameter = Resolve_Parameter(name);
+				scgms::IFilter_Parameter* parameter = Find_Parameter(name);
 				if (parameter) {
 
 					scgms::IModel_Parameter_Vector *raw_parameters;
@@ -207,26 +211,44 @@ namespace scgms {
 				return success;
 			}
 
+			//non-owning, the parameter stays valid as long as the configuration is not modified
+			scgms::IFilter_Parameter* Find_Parameter(const wchar_t* name) const {
+				if ((!name) || (!refcnt::SReferenced<IConfiguration>::operator bool()))
+					return nullptr;
+
+				IConfiguration* configuration = refcnt::SReferenced<IConfiguration>::get();
+
+				//configuration links keep their parameters indexed by the config name
+				scgms::IFilter_Configuration_Index* index;
+				if (configuration->QueryInterface(&IID_Filter_Configuration_Index, reinterpret_cast<void**>(&index)) == S_OK) {
+					scgms::IFilter_Parameter* result;
+					if (index->Find_Parameter(name, &result) != S_OK)
+						result = nullptr;
+					index->Release();
+					return result;
+				}
+
+				//a duplicated name resolves to the last parameter, hence the scan from the end
+				scgms::IFilter_Parameter **cbegin, **cend;
+				if (configuration->get(&cbegin, &cend) == S_OK)
+					for (scgms::IFilter_Parameter** cur = cend; cur != cbegin; ) {
+						cur--;
+						wchar_t* conf_name;
+						if (((*cur)->Get_Config_Name(&conf_name) == S_OK) && (wcscmp(conf_name, name) == 0))
+							return *cur;
+					}
+
+				return nullptr;	//not found
+			}
+
 			SFilter_Parameter Resolve_Parameter(const wchar_t* name) const {
 				SFilter_Parameter result;
 
-				if (name) {
-					if (refcnt::SReferenced<IConfiguration>::operator bool()) {
-						scgms::IFilter_Parameter **cbegin, **cend;
-						if (refcnt::SReferenced<IConfiguration>::get()->get(&cbegin, &cend) == S_OK)
-
-							for (scgms::IFilter_Parameter** cur = cbegin; cur != cend; cur++) {
-								wchar_t* conf_name;
-								if ((*cur)->Get_Config_Name(&conf_name) == S_OK) {
-									if (wcscmp(conf_name, name) == 0) {
-										result = refcnt::make_shared_reference_ext<SFilter_Parameter, scgms::IFilter_Parameter>(*cur, true);
-									}
-								}
-							}
-					}
-				}
+				scgms::IFilter_Parameter* parameter = Find_Parameter(name);
+				if (parameter)
+					result = refcnt::make_shared_reference_ext<SFilter_Parameter, scgms::IFilter_Parameter>(parameter, true);
 
-				return result;	//not found
+				return result;	//empty, if not found
 			}
 
 			void for_each(std::function<void(scgms::SFilter_Parameter)> callback) {
@@ -326,6 +348,7 @@ namespace scgms {
 	public:
 		SFilter_Executor() : refcnt::SReferenced<scgms::IFilter_Executor>() {};
 		SFilter_Executor(refcnt::SReferenced<scgms::IFilter_Chain_Configuration> configuration, scgms::TOn_Filter_Created on_filter_created, const void* on_filter_created_data, refcnt::Swstr_list error_description, scgms::IFilter *output = nullptr);
+		SFilter_Executor(refcnt::SReferenced<scgms::IFilter_Chain_Configuration> configuration, const scgms::NExecution_Flags execution_flags, scgms::TOn_Filter_Created on_filter_created, const void* on_filter_created_data, refcnt::Swstr_list error_description, refcnt::Swstr_list elided_filters, scgms::IFilter *output = nullptr);
 
 		HRESULT Execute(scgms::UDevice_Event &&event);
 	};
@@ -417,23 +440,23 @@ namespace scgms {
 		SDiscrete_Model(const GUID &id, const std::vector<double> &parameters, scgms::SFilter output);
 	};
 
-	class SDrawing_Filter_Inspection : public std::shared_ptr<IDrawing_Filter_Inspection> {
+	class SDrawing_Filter_Inspection : public virtual refcnt::SReferenced<IDrawing_Filter_Inspection> {
 	public:
 		SDrawing_Filter_Inspection() noexcept {};
 		SDrawing_Filter_Inspection(const SFilter &drawing_filter);
 	};
 
-	class SDrawing_Filter_Inspection_v2 : public std::shared_ptr<IDrawing_Filter_Inspection_v2> {
+	class SDrawing_Filter_Inspection_v2 : public virtual refcnt::SReferenced<IDrawing_Filter_Inspection_v2> {
 	public:
 		SDrawing_Filter_Inspection_v2() noexcept {};
 		SDrawing_Filter_Inspection_v2(const SFilter& drawing_filter);
 	};
 
-	class SLog_Filter_Inspection : public std::shared_ptr<ILog_Filter_Inspection> {
+	class SLog_Filter_Inspection : public virtual refcnt::SReferenced<ILog_Filter_Inspection> {
 	public:
 		SLog_Filter_Inspection() noexcept {};
 		SLog_Filter_Inspection(const SFilter &log_filter);
-		bool pop(std::shared_ptr<refcnt::wstr_list> &list);
+		bool pop(refcnt::SReferenced<refcnt::wstr_list> &list);
 	};
 
 	class SSignal_Error_Inspection : public virtual refcnt::SReferenced<scgms::ISignal_Error_Inspection> {
@@ -442,7 +465,7 @@ namespace scgms {
 		SSignal_Error_Inspection(const SFilter &signal_error_filter);
 	};
 
-	class SEvent_Export_Filter_Inspection : public std::shared_ptr<scgms::IEvent_Export_Filter_Inspection> {
+	class SEvent_Export_Filter_Inspection : public virtual refcnt::SReferenced<scgms::IEvent_Export_Filter_Inspection> {
 	public:
 		SEvent_Export_Filter_Inspection() noexcept {};
 		SEvent_Export_Filter_Inspection(const SFilter &event_export_filter);
@@ -0,0 +1,268 @@
+/**
+ * SmartCGMS - continuous glucose monitoring and controlling framework
+ * https://diabetes.zcu.cz/
+ *
+ * Copyright (c) since 2018 University of West Bohemia.
+ *
+ * Contact:
+ * diabetes@mail.kiv.zcu.cz
+ * Medical Informatics, Department of Computer Science and Engineering
+ * Faculty of Applied Sciences, University of West Bohemia
+ * Univerzitni 8, 301 00 Pilsen
+ * Czech Republic
+ * 
+ * 
+ * Purpose of this software:
+ * This software is intended to demonstrate work of the diabetes.zcu.cz research
+ * group to other scientists, to complement our published papers. It is strictly
+ * prohibited to use this software for diagnosis or treatment of any medical condition,
+ * without obtaining all required approvals from respective regulatory bodies.
+ *
+ * Especially, a diabetic patient is warned that unauthorized use of this software
+ * may result into severe injure, including death.
+ *
+ *
+ * Licensing terms:
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * a) This file is available under the Apache License, Version 2.0.
+ * b) When publishing any derivative work or results obtained using this software, you agree to cite the following paper:
+ *    Tomas Koutny and Martin Ubl, "SmartCGMS as a Testbed for a Blood-Glucose Level Prediction and/or 
+ *    Control Challenge with (an FDA-Accepted) Diabetic Patient Simulation", Procedia Computer Science,  
+ *    Volume 177, pp. 354-362, 2020
+ */
+
+#pragma once
+
+#include "FilterLib.h"
+#include "../lang/dstrings.h"
+#include "../utils/string_utils.h"
+
+#include <cwchar>
+#include <tuple>
+#include <utility>
+
+//Typed filter parameters, validated against the filter descriptor and read in a single pass at the configure time,
+//so that the hot path reads plain members instead of looking the parameters up by their config names:
+//	struct TParameters {
+//		double scale = 1.0;
+//		int64_t count = 10;
+//	};
+//
+//	static const auto parameters_schema = scgms::Make_Parameter_Schema(
+//		scgms::Parameter_Field(rsScale, &TParameters::scale),
+//		scgms::Parameter_Field(rsCount, &TParameters::count, scgms::NParameter_Presence::Optional));
+//
+//	HRESULT CFoo::Do_Configure(scgms::SFilter_Configuration configuration, refcnt::Swstr_list& error_description) {
+//		return parameters_schema.Bind(configuration, foo_descriptor, mParameters, error_description);
+//	}
+//
+//An optional parameter, which is not configured, keeps the member initializer. The target is assigned only if all the fields bind.
+namespace scgms {
+
+	enum class NParameter_Presence : uint8_t {
+		Required,
+		Optional
+	};
+
+	namespace parameter_schema {
+
+		//maps a member type to the parameter types it can hold, and to the SFilter_Parameter accessor that reads it
+		template <typename T>
+		struct TField_Type;
+
+		template <>
+		struct TField_Type<double> {
+			static bool Accepts(const NParameter_Type type) {
+				return (type == NParameter_Type::ptDouble) || (type == NParameter_Type::ptRatTime);
+			}
+
+			static double Read(SFilter_Parameter &parameter, HRESULT &rc) {
+				return parameter.as_double(rc);
+			}
+		};
+
+		template <>
+		struct TField_Type<int64_t> {
+			static bool Accepts(const NParameter_Type type) {
+				return (type == NParameter_Type::ptInt64) || (type == NParameter_Type::ptSubject_Id);
+			}
+
+			static int64_t Read(SFilter_Parameter &parameter, HRESULT &rc) {
+				return parameter.as_int(rc);
+			}
+		};
+
+		template <>
+		struct TField_Type<bool> {
+			static bool Accepts(const NParameter_Type type) {
+				return type == NParameter_Type::ptBool;
+			}
+
+			static bool Read(SFilter_Parameter &parameter, HRESULT &rc) {
+				return parameter.as_bool(rc);
+			}
+		};
+
+		template <>
+		struct TField_Type<GUID> {
+			static bool Accepts(const NParameter_Type type) {
+				switch (type) {
+					case NParameter_Type::ptSignal_Model_Id:
+					case NParameter_Type::ptDiscrete_Model_Id:
+					case NParameter_Type::ptMetric_Id:
+					case NParameter_Type::ptSolver_Id:
+					case NParameter_Type::ptModel_Produced_Signal_Id:
+					case NParameter_Type::ptSignal_Id:
+						return true;
+
+					default:
+						return false;
+				}
+			}
+
+			static GUID Read(SFilter_Parameter &parameter, HRESULT &rc) {
+				return parameter.as_guid(rc);
+			}
+		};
+
+		template <>
+		struct TField_Type<std::wstring> {
+			static bool Accepts(const NParameter_Type type) {
+				return type == NParameter_Type::ptWChar_Array;
+			}
+
+			static std::wstring Read(SFilter_Parameter &parameter, HRESULT &rc) {
+				return parameter.as_wstring(rc, true);
+			}
+		};
+
+		template <>
+		struct TField_Type<std::vector<double>> {
+			static bool Accepts(const NParameter_Type type) {
+				return type == NParameter_Type::ptDouble_Array;
+			}
+
+			static std::vector<double> Read(SFilter_Parameter &parameter, HRESULT &rc) {
+				return parameter.as_double_array(rc);
+			}
+		};
+
+		template <>
+		struct TField_Type<std::vector<int64_t>> {
+			static bool Accepts(const NParameter_Type type) {
+				return type == NParameter_Type::ptInt64_Array;
+			}
+
+			static std::vector<int64_t> Read(SFilter_Parameter &parameter, HRESULT &rc) {
+				return parameter.as_int_array(rc);
+			}
+		};
+
+		//Filter(1)-parameter(2) messages of dstrings
+		inline std::wstring Describe_Field(const wchar_t* message, const TFilter_Descriptor &descriptor, const wchar_t* config_name) {
+			std::wstring result = message;
+			result.append(descriptor.description ? descriptor.description : GUID_To_WString(descriptor.id).c_str());
+			result.append(L" (2)");
+			result.append(config_name);
+			return result;
+		}
+	}
+
+	template <typename S, typename T>
+	struct TParameter_Field {
+		using TValue = T;
+
+		const wchar_t* config_name;
+		T S::* member;
+		NParameter_Presence presence;
+	};
+
+	template <typename S, typename T>
+	TParameter_Field<S, T> Parameter_Field(const wchar_t* config_name, T S::* member, const NParameter_Presence presence = NParameter_Presence::Required) {
+		return TParameter_Field<S, T>{ config_name, member, presence };
+	}
+
+	template <typename S, typename... T>
+	class CParameter_Schema {
+	protected:
+		std::tuple<TParameter_Field<S, T>...> mFields;
+
+		template <typename F>
+		void For_Each_Field(F &&callback) const {
+			std::apply([&callback](const auto&... field) { (callback(field), ...); }, mFields);
+		}
+	public:
+		CParameter_Schema(const TParameter_Field<S, T>&... fields) : mFields(fields...) {}
+
+		//checks that the descriptor declares every field, with a type the member can hold
+		bool Validate(const TFilter_Descriptor &descriptor, refcnt::Swstr_list &error_description) const {
+			bool valid = true;
+
+			For_Each_Field([&](const auto &field) {
+				using TValue = typename std::decay_t<decltype(field)>::TValue;
+
+				for (size_t i = 0; i < descriptor.parameters_count; i++) {
+					if ((descriptor.config_parameter_name[i] != nullptr) && (wcscmp(descriptor.config_parameter_name[i], field.config_name) == 0)) {
+						if (parameter_schema::TField_Type<TValue>::Accepts(descriptor.parameter_type[i]))
+							return;
+						break;
+					}
+				}
+
+				error_description.push(parameter_schema::Describe_Field(dsParameter_Schema_Mismatch, descriptor, field.config_name).c_str());
+				valid = false;
+			});
+
+			return valid;
+		}
+
+		//reads all the fields into the target, or reports every field that failed and leaves the target intact
+		HRESULT Bind(SFilter_Configuration &configuration, const TFilter_Descriptor &descriptor, S &target, refcnt::Swstr_list &error_description) const {
+			if (!Validate(descriptor, error_description))
+				return E_INVALIDARG;
+
+			S staged = target;
+			bool bound = true;
+
+			For_Each_Field([&](const auto &field) {
+				using TValue = typename std::decay_t<decltype(field)>::TValue;
+
+				SFilter_Parameter parameter = configuration.Resolve_Parameter(field.config_name);
+				if (!parameter) {
+					if (field.presence == NParameter_Presence::Required) {
+						error_description.push(parameter_schema::Describe_Field(dsRequired_Filter_Parameter_Not_Configured, descriptor, field.config_name).c_str());
+						bound = false;
+					}
+					return;
+				}
+
+				HRESULT rc = E_FAIL;
+				TValue value = parameter_schema::TField_Type<TValue>::Read(parameter, rc);
+				if (rc == S_OK) {
+					staged.*(field.member) = std::move(value);
+					return;
+				}
+
+				std::wstring error_desc = parameter_schema::Describe_Field(dsFilter_configuration_param_value_error, descriptor, field.config_name);
+				error_desc.append(L" (3)");
+				error_desc.append(parameter.as_wstring(rc, false));
+				error_description.push(error_desc.c_str());
+				bound = false;
+			});
+
+			if (!bound)
+				return E_INVALIDARG;
+
+			target = std::move(staged);
+			return S_OK;
+		}
+	};
+
+	template <typename S, typename... T>
+	CParameter_Schema<S, T...> Make_Parameter_Schema(const TParameter_Field<S, T>&... fields) {
+		return CParameter_Schema<S, T...>{ fields... };
+	}
+}
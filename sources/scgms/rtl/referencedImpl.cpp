@@ -37,6 +37,9 @@
 #include "referencedImpl.h"
 
 #include "manufactory.h"
+#if defined(SCGMS_UTF8_STRINGS)
+#include "../utils/string_utils.h"
+#endif
 #include <limits>
 #include <algorithm>
 #include <iostream>
@@ -51,10 +54,16 @@ namespace refcnt {
 	}
 
 	ULONG IfaceCalling CReferenced::AddRef() {
+#if defined(SCGMS_REFCNT_THREAD_CHECK)
+		assert(mOwner_Thread == std::this_thread::get_id() && "single-threaded refcount used from another thread");
+#endif
 		return mCounter++ + 1;
 	}
 
 	ULONG IfaceCalling CReferenced::Release() {
+#if defined(SCGMS_REFCNT_THREAD_CHECK)
+		assert(mOwner_Thread == std::this_thread::get_id() && "single-threaded refcount used from another thread");
+#endif
 		ULONG rc = mCounter-- - 1;	//fetch_sub returns the old value!
 		if (rc == 0) delete this;
 
@@ -79,17 +88,118 @@ namespace refcnt {
 		return Container_To_Vector<wchar_t, std::wstring>(container);
 	}
 
-	std::shared_ptr<wstr_container> WString_To_WChar_Container_shared(const wchar_t* str) {
+#if defined(SCGMS_UTF8_STRINGS)
+	namespace internal {
+
+		void CUTF8_String_Container::Widen() const {
+			if (!mWide_Valid) {
+				mWide = Widen_UTF8(mText);
+				mWide_Valid = true;
+			}
+		}
+
+		void CUTF8_String_Container::Narrow() {
+			mText = Narrow_UTF8(mWide);
+		}
+
+		HRESULT IfaceCalling CUTF8_String_Container::set(wchar_t *begin, wchar_t *end) {
+			mText.clear();
+			return add(begin, end);
+		}
+
+		HRESULT IfaceCalling CUTF8_String_Container::add(wchar_t *begin, wchar_t *end) {
+			if ((begin != nullptr) && (begin < end))
+				mText += Narrow_UTF8(std::wstring_view{ begin, static_cast<size_t>(std::distance(begin, end)) });
+
+			mWide.clear();
+			mWide.shrink_to_fit();
+			mWide_Valid = false;
+			return S_OK;
+		}
+
+		HRESULT IfaceCalling CUTF8_String_Container::get(wchar_t **begin, wchar_t **end) const {
+			if (mText.empty()) {
+				*begin = *end = nullptr;
+				return S_FALSE;
+			}
+
+			Widen();
+			*begin = const_cast<wchar_t*>(mWide.data());
+			*end = *begin + mWide.size();
+			return S_OK;
+		}
+
+		HRESULT IfaceCalling CUTF8_String_Container::pop(wchar_t* value) {
+			if (mText.empty()) return S_FALSE;
+
+			Widen();
+			*value = mWide.back();
+			mWide.pop_back();
+			Narrow();
+			return S_OK;
+		}
+
+		HRESULT IfaceCalling CUTF8_String_Container::remove(const size_t index) {
+			if (mText.empty()) return S_FALSE;
+
+			Widen();
+			if (index >= mWide.size()) return E_INVALIDARG;
+			mWide.erase(mWide.begin() + index);
+			Narrow();
+			return S_OK;
+		}
+
+		HRESULT IfaceCalling CUTF8_String_Container::move(const size_t from_index, const size_t to_index) {
+			Widen();
+			const size_t sz = mWide.size();
+			if ((from_index >= sz) ||
+				(to_index >= sz) ||
+				(from_index == to_index)) return E_INVALIDARG;
+
+			if (from_index < to_index)
+				std::rotate(mWide.begin() + from_index, mWide.begin() + from_index + 1, mWide.begin() + to_index + 1);
+			else
+				std::rotate(mWide.begin() + to_index, mWide.begin() + from_index, mWide.begin() + from_index + 1);
+
+			Narrow();
+			return S_OK;
+		}
+
+		HRESULT IfaceCalling CUTF8_String_Container::empty() const {
+			return mText.empty() ? S_OK : S_FALSE;
+		}
+	}
+
+	SReferenced<wstr_container> WString_To_WChar_Container_shared(const wchar_t* str) {
+		SCGMS_HEAP_TAG(Strings);
+		return refcnt::make_shared_reference_ext<SReferenced<wstr_container>, wstr_container>(WString_To_WChar_Container(str), false);
+	}
+
+	wstr_container* WString_To_WChar_Container(const wchar_t* str) {
+		SCGMS_HEAP_TAG(Strings);
+		const size_t len = str != nullptr ? wcslen(str) : 0;
+		wchar_t *str_ptr = const_cast<wchar_t*>(str);
+
+		wstr_container *obj = nullptr;
+		if (Manufacture_Object<internal::CUTF8_String_Container, wstr_container>(&obj) == S_OK)
+			obj->set(str_ptr, str_ptr + len);
+		return obj;
+	}
+#else
+	SReferenced<wstr_container> WString_To_WChar_Container_shared(const wchar_t* str) {
+		SCGMS_HEAP_TAG(Strings);
 		const size_t len = str != nullptr ? wcslen(str) : 0;
 		wchar_t *str_ptr = const_cast<wchar_t*>(str);
 		return Create_Container_shared<wchar_t>(str_ptr, str_ptr + len);
 	}
 
 	wstr_container* WString_To_WChar_Container(const wchar_t* str) {
+		SCGMS_HEAP_TAG(Strings);
 		const size_t len = str != nullptr ? wcslen(str) : 0;
 		wchar_t *str_ptr = const_cast<wchar_t*>(str);
 		return Create_Container<wchar_t>(str_ptr, str_ptr + len);
 	}
+#endif
 
 	bool WChar_Container_Equals_WString(wstr_container *container, const wchar_t* str, size_t offset, size_t maxCount) {
 		wchar_t *cont_begin, *cont_end;
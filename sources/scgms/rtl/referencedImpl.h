@@ -39,6 +39,7 @@
 #include "../iface/referencedIface.h"
 #include "manufactory.h"
 #include "AlignmentAllocator.h"
+#include "../utils/heap_profiler.h"
 
 #include <atomic>
 #include <string>
@@ -46,15 +47,27 @@
 #include <algorithm>
 #include <functional>
 #include <iterator>
+#include <type_traits>
+
+//SCGMS_SINGLE_THREADED_REFCNT is for builds, which run the whole chain on a single thread - the reference counters
+//do not need to be atomic then. Debug ESP32 builds assert that each object is referenced by the thread that created it.
+#if defined(SCGMS_SINGLE_THREADED_REFCNT) && defined(ESP32) && !defined(NDEBUG)
+	#define SCGMS_REFCNT_THREAD_CHECK
+	#include <cassert>
+	#include <thread>
+#endif
 
 namespace refcnt {
 
 	class CReferenced : public virtual IReferenced {
 	protected:
-#if defined(ESP32) || defined(WASM)
+#if (defined(ESP32) || defined(WASM)) && !defined(SCGMS_SINGLE_THREADED_REFCNT)
 		std::atomic<ULONG> mCounter;
-#elif defined(FREERTOS)
+#elif defined(FREERTOS) || defined(ESP32) || defined(WASM)
 		ULONG mCounter;
+#endif
+#if defined(SCGMS_REFCNT_THREAD_CHECK)
+		const std::thread::id mOwner_Thread = std::this_thread::get_id();
 #endif
 		template <typename I>
 		bool Internal_Query_Interface(const GUID &I_id, const GUID &riid, void **ppvObj) {
@@ -83,21 +96,87 @@ namespace refcnt {
 	};
 
 
+	//Intrusive reference, which add_refs and releases the object itself - unlike std::shared_ptr, there is no control block to allocate.
+	//It keeps the shared_ptr-like interface of get, reset and operator bool, so that the S* wrappers can extend it the same way.
 	template <typename I>
-	class SReferenced : public std::shared_ptr<I> {
+	class SReferenced {
+	protected:
+		I* mObj = nullptr;
+		bool mBorrowed = false;		//the caller guarantees the lifetime, so that we neither add_ref nor release
+
+		void Release_Obj() noexcept {
+			if ((mObj != nullptr) && !mBorrowed)
+				mObj->Release();
+			mObj = nullptr;
+			mBorrowed = false;
+		}
 	public:
-		SReferenced() : std::shared_ptr<I>() {}
+		using element_type = I;
+
+		SReferenced() noexcept {}
+		SReferenced(std::nullptr_t) noexcept {}
 
-		SReferenced(I *obj) {			
-			if (obj) obj->AddRef();
-			std::shared_ptr<I>::reset(obj, [](I* obj_to_release) { if (obj_to_release != nullptr) obj_to_release->Release(); });
-		}		
+		SReferenced(I *obj) noexcept : mObj(obj) {
+			if (mObj) mObj->AddRef();
+		}
 
-		virtual ~SReferenced() = default;
+		//a copy of a borrowed reference owns the object, so that it may outlive the original
+		SReferenced(const SReferenced &other) noexcept : mObj(other.mObj) {
+			if (mObj) mObj->AddRef();
+		}
+
+		SReferenced(SReferenced &&other) noexcept : mObj(other.mObj), mBorrowed(other.mBorrowed) {
+			other.mObj = nullptr;
+			other.mBorrowed = false;
+		}
+
+		virtual ~SReferenced() {
+			Release_Obj();
+		}
+
+		SReferenced& operator=(const SReferenced &other) noexcept {
+			if (other.mObj) other.mObj->AddRef();	//first, as other may be the only owner of the current object
+			Release_Obj();
+			mObj = other.mObj;
+			return *this;
+		}
+
+		//no move assignment - the S* wrappers derive from this class virtually, so that their defaulted move assignment could move it twice;
+		//an rvalue is assigned by the copy above then, which costs just an add_ref and leaves the source as it was
+
+		SReferenced& operator=(std::nullptr_t) noexcept {
+			Release_Obj();
+			return *this;
+		}
 
 		SReferenced& operator=(I*) = delete;
-		template< class Y, class Deleter >
-		SReferenced& operator=(std::unique_ptr<Y, Deleter>&& r) = delete;
+
+		I* get() const noexcept { return mObj; }
+		I* operator->() const noexcept { return mObj; }
+		I& operator*() const noexcept { return *mObj; }
+		explicit operator bool() const noexcept { return mObj != nullptr; }
+
+		void reset() noexcept {
+			Release_Obj();
+		}
+
+		//takes over the caller's reference, e.g.; the one returned by a factory, without add_refing it
+		void attach(I *obj) noexcept {
+			Release_Obj();
+			mObj = obj;
+		}
+
+		//refers to obj without owning it, see make_borrowed_reference_ext
+		void borrow(I *obj) noexcept {
+			Release_Obj();
+			mObj = obj;
+			mBorrowed = obj != nullptr;
+		}
+
+		bool operator==(const SReferenced &other) const noexcept { return mObj == other.mObj; }
+		bool operator!=(const SReferenced &other) const noexcept { return mObj != other.mObj; }
+		bool operator==(std::nullptr_t) const noexcept { return mObj == nullptr; }
+		bool operator!=(std::nullptr_t) const noexcept { return mObj != nullptr; }
 	};
 
 	template <class T, class I, class S, typename... Args>
@@ -237,6 +316,233 @@ namespace refcnt {
 		};
 
 
+		//the inline storage of CSmall_Vector_Container, e.g.; 32 wchar_t or 16 doubles
+		constexpr size_t Small_Container_Bytes = 128;
+
+		template <typename T>
+		constexpr size_t Small_Container_Capacity = (Small_Container_Bytes / sizeof(T)) > 0 ? (Small_Container_Bytes / sizeof(T)) : 1;
+
+		//references need add_ref/release per item, hence they stay with CVector_Container
+		template <typename T>
+		constexpr bool Is_Small_Container_Type = std::is_trivially_copyable<T>::value && !std::is_pointer<T>::value;
+
+		//Keeps small payloads of plain values inline, so that an error string, parameter bounds or a segment id list
+		//cost a single allocation. Once it outgrows the inline storage, it spills into the heap;
+		//either way, get returns a contiguous span that stays valid until the next modification.
+		template <typename T, size_t N = Small_Container_Capacity<T>>
+		class CSmall_Vector_Container : public virtual IVector_Container<T>, public virtual CReferenced {
+			static_assert(Is_Small_Container_Type<T>, "CSmall_Vector_Container holds plain values only");
+		protected:
+			T mInline[N];
+			size_t mInline_Count = 0;
+			std::vector<T, AlignmentAllocator<T>> mSpilled;
+			bool mIs_Spilled = false;
+
+			T* Data() const {
+				return const_cast<T*>(mIs_Spilled ? mSpilled.data() : mInline);
+			}
+
+			size_t Size() const {
+				return mIs_Spilled ? mSpilled.size() : mInline_Count;
+			}
+		public:
+			virtual ~CSmall_Vector_Container() = default;
+
+			virtual HRESULT IfaceCalling set(T *begin, T *end) override final {
+				mInline_Count = 0;
+				mSpilled.clear();
+				mIs_Spilled = false;
+				return add(begin, end);
+			}
+
+			virtual HRESULT IfaceCalling add(T *begin, T *end) override final {
+				if ((begin == nullptr) || (end <= begin))
+					return S_OK;
+
+				const size_t count = static_cast<size_t>(end - begin);
+				if (!mIs_Spilled && (mInline_Count + count <= N)) {
+					std::copy(begin, end, mInline + mInline_Count);
+					mInline_Count += count;
+					return S_OK;
+				}
+
+				if (!mIs_Spilled) {
+					mSpilled.reserve(mInline_Count + count);
+					mSpilled.assign(mInline, mInline + mInline_Count);
+					mIs_Spilled = true;
+				}
+
+				mSpilled.insert(mSpilled.end(), begin, end);
+				return S_OK;
+			}
+
+			virtual HRESULT IfaceCalling get(T **begin, T **end) const override final {
+				const size_t sz = Size();
+				if (sz > 0) {
+					*begin = Data();
+					*end = *begin + sz;
+					return S_OK;
+				} else {
+					*begin = *end = nullptr;
+					return S_FALSE;
+				}
+			}
+
+			virtual HRESULT IfaceCalling pop(T* value) override final {
+				const size_t sz = Size();
+				if (sz == 0) return S_FALSE;
+
+				*value = Data()[sz - 1];
+				if (mIs_Spilled)
+					mSpilled.pop_back();
+				else
+					mInline_Count--;
+
+				return S_OK;
+			}
+
+			virtual HRESULT IfaceCalling remove(const size_t index) override final {
+				const size_t sz = Size();
+				if (sz == 0) return S_FALSE;
+				if (index >= sz) return E_INVALIDARG;
+
+				if (mIs_Spilled)
+					mSpilled.erase(mSpilled.begin() + index);
+				else {
+					std::copy(mInline + index + 1, mInline + mInline_Count, mInline + index);
+					mInline_Count--;
+				}
+
+				return S_OK;
+			}
+
+			virtual HRESULT IfaceCalling move(const size_t from_index, const size_t to_index) override final {
+				const size_t sz = Size();
+				if ((from_index >= sz) ||
+					(to_index >= sz) ||
+					(from_index == to_index)) return E_INVALIDARG;
+
+				T* data = Data();
+				if (from_index < to_index)	//as CVector_Container::move does
+					std::rotate(data + from_index, data + from_index + 1, data + to_index + 1);
+				else
+					std::rotate(data + to_index, data + from_index, data + from_index + 1);
+
+				return S_OK;
+			}
+
+			virtual HRESULT IfaceCalling empty() const override final {
+				return Size() == 0 ? S_OK : S_FALSE;
+			}
+		};
+
+
+		//For the vectorized kernels: the items start on the Alignment boundary, and the storage is padded with zeros
+		//to a whole multiple of Alignment. Hence, the kernel may use the aligned loads, and process the tail as a full vector
+		//- reading past get's end, up to the padded size, is valid until the next modification.
+		template <typename T, size_t Alignment = AVX2Alignment>
+		class CPadded_Vector_Container : public virtual IVector_Container<T>, public virtual CReferenced {
+			static_assert(std::is_arithmetic<T>::value, "CPadded_Vector_Container holds numbers only");
+			static_assert((Alignment % sizeof(T)) == 0, "the alignment must be a whole multiple of the item size");
+		protected:
+			static constexpr size_t Lane_Count = Alignment / sizeof(T);
+
+			T* mData = nullptr;
+			size_t mCount = 0;
+			size_t mCapacity = 0;		//a whole multiple of Lane_Count, items past mCount are zero
+
+			bool Reserve(const size_t count) {
+				if (count <= mCapacity) return true;
+
+				size_t capacity = std::max(count, 2 * mCapacity);
+				capacity = ((capacity + Lane_Count - 1) / Lane_Count) * Lane_Count;
+
+				T* data = static_cast<T*>(_aligned_malloc(capacity * sizeof(T), Alignment));
+				if (data == nullptr) return false;
+
+				std::copy(mData, mData + mCount, data);
+				std::fill(data + mCount, data + capacity, T{});
+				_aligned_free(mData);
+
+				mData = data;
+				mCapacity = capacity;
+				return true;
+			}
+		public:
+			virtual ~CPadded_Vector_Container() { _aligned_free(mData); }
+
+			size_t Padded_Size() const {
+				return ((mCount + Lane_Count - 1) / Lane_Count) * Lane_Count;
+			}
+
+			virtual HRESULT IfaceCalling set(T *begin, T *end) override final {
+				std::fill(mData, mData + mCount, T{});
+				mCount = 0;
+				return add(begin, end);
+			}
+
+			virtual HRESULT IfaceCalling add(T *begin, T *end) override final {
+				if ((begin == nullptr) || (end <= begin))
+					return S_OK;
+
+				const size_t count = static_cast<size_t>(end - begin);
+				if (!Reserve(mCount + count))
+					return E_OUTOFMEMORY;
+
+				std::copy(begin, end, mData + mCount);
+				mCount += count;
+				return S_OK;
+			}
+
+			virtual HRESULT IfaceCalling get(T **begin, T **end) const override final {
+				if (mCount > 0) {
+					*begin = mData;
+					*end = mData + mCount;
+					return S_OK;
+				} else {
+					*begin = *end = nullptr;
+					return S_FALSE;
+				}
+			}
+
+			virtual HRESULT IfaceCalling pop(T* value) override final {
+				if (mCount == 0) return S_FALSE;
+
+				mCount--;
+				*value = mData[mCount];
+				mData[mCount] = T{};
+				return S_OK;
+			}
+
+			virtual HRESULT IfaceCalling remove(const size_t index) override final {
+				if (mCount == 0) return S_FALSE;
+				if (index >= mCount) return E_INVALIDARG;
+
+				std::copy(mData + index + 1, mData + mCount, mData + index);
+				mCount--;
+				mData[mCount] = T{};
+				return S_OK;
+			}
+
+			virtual HRESULT IfaceCalling move(const size_t from_index, const size_t to_index) override final {
+				if ((from_index >= mCount) ||
+					(to_index >= mCount) ||
+					(from_index == to_index)) return E_INVALIDARG;
+
+				if (from_index < to_index)	//as CVector_Container::move does
+					std::rotate(mData + from_index, mData + from_index + 1, mData + to_index + 1);
+				else
+					std::rotate(mData + to_index, mData + from_index, mData + from_index + 1);
+
+				return S_OK;
+			}
+
+			virtual HRESULT IfaceCalling empty() const override final {
+				return mCount == 0 ? S_OK : S_FALSE;
+			}
+		};
+
+
 		template <typename T>
 		class CVector_View : public virtual IVector_Container<T>, public virtual CNotReferenced  {
 		protected:
@@ -253,6 +559,31 @@ namespace refcnt {
 			virtual HRESULT IfaceCalling empty() const override final { return mEnd <= mBegin ? S_OK : S_FALSE; };
 		};
 
+#if defined(SCGMS_UTF8_STRINGS)
+		//wchar_t is 4 bytes on our targets, so that the strings are kept as UTF-8 and widened on the first get only
+		//the widened copy stays valid until the next modification, as with CVector_Container
+		//like the other containers, it is not synchronized - concurrent readers must not be the first ones to call get
+		class CUTF8_String_Container : public virtual wstr_container, public virtual CReferenced {
+		protected:
+			std::string mText;
+			mutable std::wstring mWide;
+			mutable bool mWide_Valid = false;
+
+			void Widen() const;
+			void Narrow();		//stores the modified mWide as mText
+		public:
+			virtual ~CUTF8_String_Container() = default;
+
+			virtual HRESULT IfaceCalling set(wchar_t *begin, wchar_t *end) override final;
+			virtual HRESULT IfaceCalling add(wchar_t *begin, wchar_t *end) override final;
+			virtual HRESULT IfaceCalling get(wchar_t **begin, wchar_t **end) const override final;
+			virtual HRESULT IfaceCalling pop(wchar_t* value) override final;
+			virtual HRESULT IfaceCalling remove(const size_t index) override final;
+			virtual HRESULT IfaceCalling move(const size_t from_index, const size_t to_index) override final;
+			virtual HRESULT IfaceCalling empty() const override final;
+		};
+#endif
+
 		#pragma warning( pop ) 
 	}
 
@@ -260,8 +591,34 @@ namespace refcnt {
 
 	template <typename T>
 	IVector_Container<T>* Create_Container(T *begin, T *end) {
+		SCGMS_HEAP_TAG(Containers);
+		IVector_Container<T> *obj = nullptr;
+		HRESULT rc = E_UNEXPECTED;
+
+		//most of the strings and parameter vectors fit the inline storage
+		if constexpr (internal::Is_Small_Container_Type<T>) {
+			if ((begin == nullptr) || (static_cast<size_t>(end - begin) <= internal::Small_Container_Capacity<T>))
+				rc = Manufacture_Object<internal::CSmall_Vector_Container<T>, IVector_Container<T>>(&obj);
+			else
+				rc = Manufacture_Object<internal::CVector_Container<T>, IVector_Container<T>>(&obj);
+		} else
+			rc = Manufacture_Object<internal::CVector_Container<T>, IVector_Container<T>>(&obj);
+
+		if (rc == S_OK) {
+			if (!Succeeded(obj->set(begin, end))) {
+				obj->Release();
+				obj = nullptr;
+			};
+		}
+		return obj;
+	}
+
+	//see internal::CPadded_Vector_Container
+	template <typename T>
+	IVector_Container<T>* Create_Padded_Container(T *begin, T *end) {
+		SCGMS_HEAP_TAG(Containers);
 		IVector_Container<T> *obj = nullptr;
-		if (Manufacture_Object<internal::CVector_Container<T>, IVector_Container<T>>(&obj) == S_OK) {
+		if (Manufacture_Object<internal::CPadded_Vector_Container<T>, IVector_Container<T>>(&obj) == S_OK) {
 			if (!Succeeded(obj->set(begin, end))) {
 				obj->Release();
 				obj = nullptr;
@@ -271,7 +628,7 @@ namespace refcnt {
 	}
 
 	template <typename T>
-	class SVector_Container : public std::shared_ptr<IVector_Container<T>> {
+	class SVector_Container : public virtual SReferenced<IVector_Container<T>> {
 	protected:
 		T* get_bound(const bool first) const {
 			//Do not cache these values as we cannot track every possible modification of the underlying vector.
@@ -280,7 +637,7 @@ namespace refcnt {
 			T* e = nullptr;
 
 			if (this->operator bool()) {
-				if (std::shared_ptr<IVector_Container<T>>::get()->get(&b, &e) != S_OK)
+				if (SReferenced<IVector_Container<T>>::get()->get(&b, &e) != S_OK)
 					return nullptr;
 			}
 
@@ -352,7 +709,7 @@ namespace refcnt {
 	
 	std::wstring WChar_Container_To_WString(wstr_container *container);
 	wstr_container* WString_To_WChar_Container(const wchar_t* str);
-	std::shared_ptr<wstr_container> WString_To_WChar_Container_shared(const wchar_t* str);
+	SReferenced<wstr_container> WString_To_WChar_Container_shared(const wchar_t* str);
 	bool WChar_Container_Equals_WString(wstr_container *container, const wchar_t* str, size_t offset = 0, size_t maxCount = (size_t)-1);
 
 
@@ -368,7 +725,7 @@ namespace refcnt {
 	}
 
 
-	class Swstr_container : public virtual std::shared_ptr<refcnt::wstr_container> {
+	class Swstr_container : public virtual refcnt::SReferenced<refcnt::wstr_container> {
 	public:
 		Swstr_container& operator=(const Swstr_container&) = default;	//https://stackoverflow.com/questions/34554612/warning-defaulted-move-assignment-operator-of-x-will-move-assign-virtual-base-c
 		void set(const wchar_t *str);
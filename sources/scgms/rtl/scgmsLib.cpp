@@ -96,6 +96,8 @@ namespace scgms {
 			const char* rsSolve_Generic = "solve_generic";
 
 			const char* rsExecute_Filter_Configuration = "execute_filter_configuration";
+			const char* rsExecute_Filter_Configuration_Ex = "execute_filter_configuration_ex";
+			const char* rsExecute_Sharded_Filter_Configuration = "execute_sharded_filter_configuration";
 			const char* rsOptimize_Parameters = "optimize_parameters";
 			const char* rsOptimize_Multiple_Parameters = "optimize_multiple_parameters";
 
@@ -116,6 +118,8 @@ namespace scgms {
 
 
 			HRESULT IfaceCalling execute_filter_configuration_not_impl(void *configuration, void* on_filter_created, void* data, void *custom_output, void *executor, void *error_description) { return E_NOTIMPL; }
+			HRESULT IfaceCalling execute_filter_configuration_ex_not_impl(void *configuration, scgms::NExecution_Flags execution_flags, void* on_filter_created, void* data, void *custom_output, void *executor, void *error_description, void *elided_filters) { return E_NOTIMPL; }
+			HRESULT IfaceCalling execute_sharded_filter_configuration_not_impl(void *configuration, size_t shard_count, scgms::NExecution_Flags execution_flags, void* on_filter_created, void* data, void *custom_output, void *executor, void *error_description, void *elided_filters) { return E_NOTIMPL; }
 			HRESULT IfaceCalling optimize_parameters_not_impl(void *cfg, size_t idx, void *parameters_configuration_name, void* on_filter_created, void* data, void *solver_id, size_t population_size, size_t max_generations, void *progress, void *error_description) { return E_NOTIMPL; }
 			HRESULT IfaceCalling optimize_multiple_parameters_not_impl(void *cfg, size_t *idx, void *parameters_configuration_name, size_t count, void* on_filter_created, void* data, void *solver_id, size_t population_size, size_t max_generations, void *progress, void *error_description) { return E_NOTIMPL; }
 
@@ -151,6 +155,8 @@ namespace scgms {
 
 
 			HRESULT IfaceCalling execute_filter_configuration_lazy(void *configuration, void* on_filter_created, void* data, void *custom_output, void *executor, void *error_description) { return factory_lazy_load(rsExecute_Filter_Configuration, configuration, on_filter_created, data, custom_output, executor, error_description); }
+			HRESULT IfaceCalling execute_filter_configuration_ex_lazy(void *configuration, scgms::NExecution_Flags execution_flags, void* on_filter_created, void* data, void *custom_output, void *executor, void *error_description, void *elided_filters) { return factory_lazy_load(rsExecute_Filter_Configuration_Ex, configuration, execution_flags, on_filter_created, data, custom_output, executor, error_description, elided_filters); }
+			HRESULT IfaceCalling execute_sharded_filter_configuration_lazy(void *configuration, size_t shard_count, scgms::NExecution_Flags execution_flags, void* on_filter_created, void* data, void *custom_output, void *executor, void *error_description, void *elided_filters) { return factory_lazy_load(rsExecute_Sharded_Filter_Configuration, configuration, shard_count, execution_flags, on_filter_created, data, custom_output, executor, error_description, elided_filters); }
 			HRESULT IfaceCalling optimize_parameters_lazy(void *cfg, size_t idx, void *parameters_cfg_name, void* on_filter_created, void* data, void *solver_id, size_t population_size, size_t max_generations, void *progress, void *error_description) { return factory_lazy_load(rsOptimize_Parameters, cfg, idx, parameters_cfg_name, on_filter_created, data, solver_id, population_size, max_generations, progress, error_description); }
 			HRESULT IfaceCalling optimize_multiple_parameters_lazy(void *cfg, size_t *idx, void *parameters_cfg_name, size_t count, void* on_filter_created, void* data, void *solver_id, size_t population_size, size_t max_generations, void *progress, void *error_description) { return factory_lazy_load(rsOptimize_Multiple_Parameters, cfg, idx, parameters_cfg_name, count, on_filter_created, data, solver_id, population_size, max_generations, progress, error_description); }
 
@@ -175,6 +181,8 @@ namespace scgms {
 
 				if (strcmp(symbol_name, rsSolve_Generic) == 0) return reinterpret_cast<void(*)>(internal::solve_generic_lazy);
 				if (strcmp(symbol_name, rsExecute_Filter_Configuration) == 0) return reinterpret_cast<void(*)>(internal::execute_filter_configuration_lazy);
+				if (strcmp(symbol_name, rsExecute_Filter_Configuration_Ex) == 0) return reinterpret_cast<void(*)>(internal::execute_filter_configuration_ex_lazy);
+				if (strcmp(symbol_name, rsExecute_Sharded_Filter_Configuration) == 0) return reinterpret_cast<void(*)>(internal::execute_sharded_filter_configuration_lazy);
 				if (strcmp(symbol_name, rsOptimize_Parameters) == 0) return reinterpret_cast<void(*)>(internal::optimize_parameters_lazy);
 				if (strcmp(symbol_name, rsOptimize_Multiple_Parameters) == 0) return reinterpret_cast<void(*)>(internal::optimize_multiple_parameters_lazy);
 
@@ -198,6 +206,8 @@ namespace scgms {
 
 				if (strcmp(symbol_name, rsSolve_Generic) == 0) return reinterpret_cast<void(*)>(internal::solve_generic_not_impl);
 				if (strcmp(symbol_name, rsExecute_Filter_Configuration) == 0) return reinterpret_cast<void(*)>(internal::execute_filter_configuration_not_impl);
+				if (strcmp(symbol_name, rsExecute_Filter_Configuration_Ex) == 0) return reinterpret_cast<void(*)>(internal::execute_filter_configuration_ex_not_impl);
+				if (strcmp(symbol_name, rsExecute_Sharded_Filter_Configuration) == 0) return reinterpret_cast<void(*)>(internal::execute_sharded_filter_configuration_not_impl);
 				if (strcmp(symbol_name, rsOptimize_Parameters) == 0) return reinterpret_cast<void(*)>(internal::optimize_parameters_not_impl);
 				if (strcmp(symbol_name, rsOptimize_Multiple_Parameters) == 0) return reinterpret_cast<void(*)>(internal::optimize_multiple_parameters_not_impl);
 	#endif
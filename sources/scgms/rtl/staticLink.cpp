@@ -4,6 +4,8 @@
 #include <scgms/src/filter_parameter.h>
 #include <scgms/src/filter_configuration_executor.h>
 #include <scgms/src/configuration_link.h>
+#include <scgms/src/optimizer.h>
+#include <scgms/src/sharded_executor.h>
 #include <generated/filters.h>
 
 void* resolve_symbol_static(const char *symbol_name) noexcept
@@ -23,6 +25,14 @@ void* resolve_symbol_static(const char *symbol_name) noexcept
 	if (strcmp(symbol_name, "execute_filter_configuration") == 0) 
     {
         return reinterpret_cast<void*>(execute_filter_configuration);
+    }
+	if (strcmp(symbol_name, "execute_filter_configuration_ex") == 0) 
+    {
+        return reinterpret_cast<void*>(execute_filter_configuration_ex);
+    }
+	if (strcmp(symbol_name, "execute_sharded_filter_configuration") == 0) 
+    {
+        return reinterpret_cast<void*>(execute_sharded_filter_configuration);
     }
 	if (strcmp(symbol_name, "create_filter_parameter") == 0) 
     {
@@ -32,6 +42,14 @@ void* resolve_symbol_static(const char *symbol_name) noexcept
     {
         return reinterpret_cast<void*>(create_filter_configuration_link);
     }
+	if (strcmp(symbol_name, "optimize_parameters") == 0) 
+    {
+        return reinterpret_cast<void*>(optimize_parameters);
+    }
+	if (strcmp(symbol_name, "optimize_multiple_parameters") == 0) 
+    {
+        return reinterpret_cast<void*>(optimize_multiple_parameters);
+    }
 
     return nullptr;
 }
\ No newline at end of file
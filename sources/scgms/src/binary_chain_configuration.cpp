@@ -0,0 +1,645 @@
+/**
+ * SmartCGMS - continuous glucose monitoring and controlling framework
+ * https://diabetes.zcu.cz/
+ *
+ * Copyright (c) since 2018 University of West Bohemia.
+ *
+ * Contact:
+ * diabetes@mail.kiv.zcu.cz
+ * Medical Informatics, Department of Computer Science and Engineering
+ * Faculty of Applied Sciences, University of West Bohemia
+ * Univerzitni 8, 301 00 Pilsen
+ * Czech Republic
+ * 
+ * 
+ * Purpose of this software:
+ * This software is intended to demonstrate work of the diabetes.zcu.cz research
+ * group to other scientists, to complement our published papers. It is strictly
+ * prohibited to use this software for diagnosis or treatment of any medical condition,
+ * without obtaining all required approvals from respective regulatory bodies.
+ *
+ * Especially, a diabetic patient is warned that unauthorized use of this software
+ * may result into severe injure, including death.
+ *
+ *
+ * Licensing terms:
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * a) This file is available under the Apache License, Version 2.0.
+ * b) When publishing any derivative work or results obtained using this software, you agree to cite the following paper:
+ *    Tomas Koutny and Martin Ubl, "SmartCGMS as a Testbed for a Blood-Glucose Level Prediction and/or 
+ *    Control Challenge with (an FDA-Accepted) Diabetic Patient Simulation", Procedia Computer Science,  
+ *    Volume 177, pp. 354-362, 2020
+ */
+
+#include "binary_chain_configuration.h"
+#include "filter_parameter.h"
+
+#include <scgms/rtl/FilterLib.h>
+#include <scgms/rtl/manufactory.h>
+#include <scgms/lang/dstrings.h>
+
+#include <cstring>
+#include <limits>
+
+namespace binary_chain {
+
+	uint64_t Hash_Source(const char *memory, const size_t len, uint64_t hash) noexcept {
+		for (size_t i = 0; i < len; i++) {
+			hash ^= static_cast<uint8_t>(memory[i]);
+			hash *= 1099511628211ULL;
+		}
+
+		return hash;
+	}
+
+	uint64_t Hash_Descriptor(const scgms::TFilter_Descriptor &desc, uint64_t hash) noexcept {
+		hash = Hash_Source(reinterpret_cast<const char*>(&desc.id), sizeof(desc.id), hash);
+		for (size_t i = 0; i < desc.parameters_count; i++) {
+			const wchar_t *config_name = desc.config_parameter_name[i] ? desc.config_parameter_name[i] : L"";
+			hash = Hash_Source(reinterpret_cast<const char*>(config_name), (wcslen(config_name) + 1) * sizeof(wchar_t), hash);	//with the terminating zero as the separator
+			const uint8_t type = static_cast<uint8_t>(desc.parameter_type[i]);
+			hash = Hash_Source(reinterpret_cast<const char*>(&type), sizeof(type), hash);
+		}
+
+		return hash;
+	}
+
+	void CWriter::Write_U8(const uint8_t value) {
+		mBinary.push_back(value);
+	}
+
+	void CWriter::Write_U16(const uint16_t value) {
+		Write_U8(static_cast<uint8_t>(value));
+		Write_U8(static_cast<uint8_t>(value >> 8));
+	}
+
+	void CWriter::Write_U32(const uint32_t value) {
+		Write_U16(static_cast<uint16_t>(value));
+		Write_U16(static_cast<uint16_t>(value >> 16));
+	}
+
+	void CWriter::Write_U64(const uint64_t value) {
+		Write_U32(static_cast<uint32_t>(value));
+		Write_U32(static_cast<uint32_t>(value >> 32));
+	}
+
+	void CWriter::Write_Double(const double value) {
+		uint64_t bits;
+		std::memcpy(&bits, &value, sizeof(bits));
+		Write_U64(bits);
+	}
+
+	void CWriter::Write_GUID(const GUID &value) {
+		Write_U32(value.Data1);
+		Write_U16(value.Data2);
+		Write_U16(value.Data3);
+		for (size_t i = 0; i < sizeof(value.Data4); i++)
+			Write_U8(value.Data4[i]);
+	}
+
+	void CWriter::Write_String(const std::wstring &value) {
+		//every wchar_t is encoded as a single code point, which makes 2-byte wchar_t surrogates round-trip too
+		std::string utf8;
+		for (const wchar_t wc : value) {
+			const uint32_t cp = static_cast<uint32_t>(wc);
+			if (cp < 0x80)
+				utf8.push_back(static_cast<char>(cp));
+			else if (cp < 0x800) {
+				utf8.push_back(static_cast<char>(0xC0 | (cp >> 6)));
+				utf8.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+			}
+			else if (cp < 0x10000) {
+				utf8.push_back(static_cast<char>(0xE0 | (cp >> 12)));
+				utf8.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+				utf8.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+			}
+			else {
+				utf8.push_back(static_cast<char>(0xF0 | (cp >> 18)));
+				utf8.push_back(static_cast<char>(0x80 | ((cp >> 12) & 0x3F)));
+				utf8.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+				utf8.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+			}
+		}
+
+		Write_U32(static_cast<uint32_t>(utf8.size()));
+		mBinary.insert(mBinary.end(), utf8.begin(), utf8.end());
+	}
+
+
+	bool CReader::Ensure(const size_t count) noexcept {
+		if (mValid && (static_cast<size_t>(mEnd - mCurrent) >= count))
+			return true;
+
+		mValid = false;
+		return false;
+	}
+
+	uint8_t CReader::Read_U8() noexcept {
+		return Ensure(1) ? *mCurrent++ : 0;
+	}
+
+	uint16_t CReader::Read_U16() noexcept {
+		const uint16_t lo = Read_U8();
+		const uint16_t hi = Read_U8();
+		return static_cast<uint16_t>(lo | (hi << 8));
+	}
+
+	uint32_t CReader::Read_U32() noexcept {
+		const uint32_t lo = Read_U16();
+		const uint32_t hi = Read_U16();
+		return lo | (hi << 16);
+	}
+
+	uint64_t CReader::Read_U64() noexcept {
+		const uint64_t lo = Read_U32();
+		const uint64_t hi = Read_U32();
+		return lo | (hi << 32);
+	}
+
+	double CReader::Read_Double() noexcept {
+		const uint64_t bits = Read_U64();
+		double value;
+		std::memcpy(&value, &bits, sizeof(value));
+		return value;
+	}
+
+	GUID CReader::Read_GUID() noexcept {
+		GUID value;
+		value.Data1 = Read_U32();
+		value.Data2 = Read_U16();
+		value.Data3 = Read_U16();
+		for (size_t i = 0; i < sizeof(value.Data4); i++)
+			value.Data4[i] = Read_U8();
+		return value;
+	}
+
+	std::wstring CReader::Read_String() {
+		const size_t len = Read_U32();
+		std::wstring result;
+		if (!Ensure(len))
+			return result;
+
+		const uint8_t *end = mCurrent + len;
+		result.reserve(len);
+		while (mCurrent < end) {
+			const uint8_t lead = *mCurrent++;
+			size_t continuation = 0;
+			uint32_t cp = lead;
+			if (lead >= 0xF0) {
+				cp = lead & 0x07;
+				continuation = 3;
+			}
+			else if (lead >= 0xE0) {
+				cp = lead & 0x0F;
+				continuation = 2;
+			}
+			else if (lead >= 0xC0) {
+				cp = lead & 0x1F;
+				continuation = 1;
+			}
+
+			if (static_cast<size_t>(end - mCurrent) < continuation) {
+				mValid = false;
+				break;
+			}
+
+			for (size_t i = 0; i < continuation; i++)
+				cp = (cp << 6) | (*mCurrent++ & 0x3F);
+
+			result.push_back(static_cast<wchar_t>(cp));
+		}
+
+		return result;
+	}
+
+
+	bool Read_Header(CReader &reader, THeader &header) noexcept {
+		header.magic = reader.Read_U32();
+		header.version = reader.Read_U16();
+		reader.Read_U16();	//reserved
+		header.source_hash = reader.Read_U64();
+		header.filters_hash = reader.Read_U64();
+		header.link_count = reader.Read_U32();
+
+		return reader.Valid() && (header.magic == Magic) && (header.version == Version);
+	}
+
+	template <typename D, typename C>
+	refcnt::SReferenced<C> Make_Array(const D *begin, const D *end) {
+		C *container = refcnt::Create_Container<D>(const_cast<D*>(begin), const_cast<D*>(end));
+		return refcnt::make_shared_reference_ext<refcnt::SReferenced<C>, C>(container, false);
+	}
+
+	template <typename D, typename C, typename R>
+	refcnt::SReferenced<C> Read_Array(CReader &reader, R read_item) {
+		//the items are encoded with the width read_item returns, so a count the rest of the blob cannot hold is malformed
+		//- and it must not get to reserve, which would attempt to allocate up to 32 GB for a corrupted one
+		constexpr size_t encoded_size = sizeof(decltype(read_item()));
+		const size_t count = reader.Read_U32();
+		if (!reader.Valid() || (count > reader.Remaining() / encoded_size))
+			return refcnt::SReferenced<C>{};
+
+		std::vector<D> values;
+		values.reserve(count);
+		for (size_t i = 0; (i < count) && reader.Valid(); i++)
+			values.push_back(static_cast<D>(read_item()));
+
+		if (!reader.Valid())
+			return refcnt::SReferenced<C>{};
+
+		return Make_Array<D, C>(values.data(), values.data() + values.size());
+	}
+
+	HRESULT Read_Parameter_Value(CReader &reader, const scgms::NParameter_Type type, const NValue_Encoding encoding, CFilter_Parameter *parameter) {
+		HRESULT rc = S_OK;
+
+		switch (encoding) {
+			case NValue_Encoding::Variable:
+			{
+				const std::wstring var_name = reader.Read_String();
+				if (parameter && reader.Valid())
+					parameter->Reference_Variable(var_name);
+			}
+			break;
+
+			case NValue_Encoding::Text:
+			{
+				const std::wstring text = reader.Read_String();
+				if (parameter && reader.Valid())
+					rc = parameter->from_string(type, text.c_str());
+			}
+			break;
+
+			case NValue_Encoding::Value:
+				switch (type) {
+					case scgms::NParameter_Type::ptRatTime:
+					case scgms::NParameter_Type::ptDouble:
+					{
+						const double value = reader.Read_Double();
+						if (parameter)
+							rc = parameter->Set_Double(value);
+					}
+					break;
+
+					case scgms::NParameter_Type::ptInt64:
+					case scgms::NParameter_Type::ptSubject_Id:
+					{
+						const int64_t value = static_cast<int64_t>(reader.Read_U64());
+						if (parameter)
+							rc = parameter->Set_Int64(value);
+					}
+					break;
+
+					case scgms::NParameter_Type::ptBool:
+					{
+						const BOOL value = reader.Read_U8() != 0 ? TRUE : FALSE;
+						if (parameter)
+							rc = parameter->Set_Bool(value);
+					}
+					break;
+
+					case scgms::NParameter_Type::ptSignal_Model_Id:
+					case scgms::NParameter_Type::ptDiscrete_Model_Id:
+					case scgms::NParameter_Type::ptMetric_Id:
+					case scgms::NParameter_Type::ptModel_Produced_Signal_Id:
+					case scgms::NParameter_Type::ptSignal_Id:
+					case scgms::NParameter_Type::ptSolver_Id:
+					{
+						const GUID value = reader.Read_GUID();
+						if (parameter)
+							rc = parameter->Set_GUID(&value);
+					}
+					break;
+
+					case scgms::NParameter_Type::ptWChar_Array:
+					{
+						const std::wstring value = reader.Read_String();
+						if (parameter && reader.Valid()) {
+							refcnt::wstr_container *container = refcnt::WString_To_WChar_Container(value.c_str());
+							rc = parameter->Set_WChar_Container(container);
+							if (container)
+								container->Release();
+						}
+					}
+					break;
+
+					case scgms::NParameter_Type::ptDouble_Array:
+					{
+						auto values = Read_Array<double, scgms::IModel_Parameter_Vector>(reader, [&reader]() { return reader.Read_Double(); });
+						if (parameter && values)
+							rc = parameter->Set_Model_Parameters(values.get());
+					}
+					break;
+
+					case scgms::NParameter_Type::ptInt64_Array:
+					{
+						auto values = Read_Array<int64_t, scgms::time_segment_id_container>(reader, [&reader]() { return reader.Read_U64(); });
+						if (parameter && values)
+							rc = parameter->Set_Time_Segment_Id_Container(values.get());
+					}
+					break;
+
+					case scgms::NParameter_Type::ptNull:
+						break;
+
+					default:
+						rc = E_INVALIDARG;
+						break;
+				}
+				break;
+
+			default:
+				rc = E_INVALIDARG;
+				break;
+		}
+
+		return (reader.Valid() && Succeeded(rc)) ? S_OK : E_INVALIDARG;
+	}
+
+	HRESULT Set_Parameter_Value(const scgms::TParameter_Entry &entry, CFilter_Parameter *parameter) {
+		HRESULT rc = S_OK;
+
+		switch (entry.encoding) {
+			case NValue_Encoding::Variable:
+				if (!entry.str)
+					return E_INVALIDARG;
+				parameter->Reference_Variable(entry.str);
+				break;
+
+			case NValue_Encoding::Text:
+				if (!entry.str)
+					return E_INVALIDARG;
+				rc = parameter->from_string(entry.type, entry.str);
+				break;
+
+			case NValue_Encoding::Value:
+				switch (entry.type) {
+					case scgms::NParameter_Type::ptRatTime:
+					case scgms::NParameter_Type::ptDouble:
+						rc = parameter->Set_Double(entry.dbl);
+						break;
+
+					case scgms::NParameter_Type::ptInt64:
+					case scgms::NParameter_Type::ptSubject_Id:
+						rc = parameter->Set_Int64(entry.int64);
+						break;
+
+					case scgms::NParameter_Type::ptBool:
+						rc = parameter->Set_Bool(entry.int64 != 0 ? TRUE : FALSE);
+						break;
+
+					case scgms::NParameter_Type::ptSignal_Model_Id:
+					case scgms::NParameter_Type::ptDiscrete_Model_Id:
+					case scgms::NParameter_Type::ptMetric_Id:
+					case scgms::NParameter_Type::ptModel_Produced_Signal_Id:
+					case scgms::NParameter_Type::ptSignal_Id:
+					case scgms::NParameter_Type::ptSolver_Id:
+						rc = parameter->Set_GUID(&entry.guid);
+						break;
+
+					case scgms::NParameter_Type::ptWChar_Array:
+					{
+						refcnt::wstr_container *container = refcnt::WString_To_WChar_Container(entry.str ? entry.str : L"");
+						rc = parameter->Set_WChar_Container(container);
+						if (container)
+							container->Release();
+					}
+					break;
+
+					case scgms::NParameter_Type::ptDouble_Array:
+					{
+						auto values = Make_Array<double, scgms::IModel_Parameter_Vector>(entry.dbl_array, entry.dbl_array + (entry.dbl_array ? entry.count : 0));
+						rc = values ? parameter->Set_Model_Parameters(values.get()) : E_OUTOFMEMORY;
+					}
+					break;
+
+					case scgms::NParameter_Type::ptInt64_Array:
+					{
+						auto values = Make_Array<int64_t, scgms::time_segment_id_container>(entry.int64_array, entry.int64_array + (entry.int64_array ? entry.count : 0));
+						rc = values ? parameter->Set_Time_Segment_Id_Container(values.get()) : E_OUTOFMEMORY;
+					}
+					break;
+
+					case scgms::NParameter_Type::ptNull:
+						break;
+
+					default:
+						rc = E_INVALIDARG;
+						break;
+				}
+				break;
+
+			default:
+				rc = E_INVALIDARG;
+				break;
+		}
+
+		return Succeeded(rc) ? S_OK : E_INVALIDARG;
+	}
+}
+
+
+namespace {
+
+	template <typename D, typename C, typename W>
+	HRESULT Write_Container(binary_chain::CWriter &writer, C *container, W write_item) {
+		D *begin = nullptr, *end = nullptr;
+		if (container && (container->get(&begin, &end) != S_OK))
+			begin = end = nullptr;
+
+		writer.Write_U32(static_cast<uint32_t>(std::distance(begin, end)));
+		for (auto iter = begin; iter != end; iter++)
+			write_item(*iter);
+
+		return S_OK;
+	}
+
+	HRESULT Write_Parameter_Value(binary_chain::CWriter &writer, scgms::IFilter_Parameter *parameter, const scgms::NParameter_Type type) {
+		refcnt::wstr_container *raw_text = nullptr;
+		if (parameter->Get_WChar_Container(&raw_text, FALSE) != S_OK)
+			return E_INVALIDARG;
+		const std::wstring text = refcnt::WChar_Container_To_WString(raw_text);
+		raw_text->Release();
+
+		auto [is_var, var_name] = scgms::Is_Variable_Name(text);
+		if (is_var) {
+			writer.Write_U8(static_cast<uint8_t>(binary_chain::NValue_Encoding::Variable));
+			writer.Write_String(var_name);
+			return S_OK;
+		}
+
+		const bool is_array = (type == scgms::NParameter_Type::ptDouble_Array) || (type == scgms::NParameter_Type::ptInt64_Array);
+		if (is_array && (text.find(L"$(") != std::wstring::npos)) {
+			//nested variables are rare, so we let CFilter_Parameter parse them, rather than extending the format
+			writer.Write_U8(static_cast<uint8_t>(binary_chain::NValue_Encoding::Text));
+			writer.Write_String(text);
+			return S_OK;
+		}
+
+		writer.Write_U8(static_cast<uint8_t>(binary_chain::NValue_Encoding::Value));
+
+		HRESULT rc = S_OK;
+		switch (type) {
+			case scgms::NParameter_Type::ptRatTime:
+			case scgms::NParameter_Type::ptDouble:
+			{
+				double value = 0.0;
+				rc = parameter->Get_Double(&value);
+				writer.Write_Double(value);
+			}
+			break;
+
+			case scgms::NParameter_Type::ptInt64:
+			case scgms::NParameter_Type::ptSubject_Id:
+			{
+				int64_t value = 0;
+				rc = parameter->Get_Int64(&value);
+				writer.Write_U64(static_cast<uint64_t>(value));
+			}
+			break;
+
+			case scgms::NParameter_Type::ptBool:
+			{
+				BOOL value = FALSE;
+				rc = parameter->Get_Bool(&value);
+				writer.Write_U8(value != FALSE ? 1 : 0);
+			}
+			break;
+
+			case scgms::NParameter_Type::ptSignal_Model_Id:
+			case scgms::NParameter_Type::ptDiscrete_Model_Id:
+			case scgms::NParameter_Type::ptMetric_Id:
+			case scgms::NParameter_Type::ptModel_Produced_Signal_Id:
+			case scgms::NParameter_Type::ptSignal_Id:
+			case scgms::NParameter_Type::ptSolver_Id:
+			{
+				GUID value = Invalid_GUID;
+				rc = parameter->Get_GUID(&value);
+				writer.Write_GUID(value);
+			}
+			break;
+
+			case scgms::NParameter_Type::ptWChar_Array:
+				writer.Write_String(text);
+				break;
+
+			case scgms::NParameter_Type::ptDouble_Array:
+			{
+				scgms::IModel_Parameter_Vector *values = nullptr;
+				rc = parameter->Get_Model_Parameters(&values);
+				if (rc == E_NOT_SET)
+					rc = S_OK;	//empty array
+				Write_Container<double>(writer, values, [&writer](const double value) { writer.Write_Double(value); });
+				if (values)
+					values->Release();
+			}
+			break;
+
+			case scgms::NParameter_Type::ptInt64_Array:
+			{
+				scgms::time_segment_id_container *values = nullptr;
+				rc = parameter->Get_Time_Segment_Id_Container(&values);
+				if (rc == E_NOT_SET)
+					rc = S_OK;
+				Write_Container<int64_t>(writer, values, [&writer](const int64_t value) { writer.Write_U64(static_cast<uint64_t>(value)); });
+				if (values)
+					values->Release();
+			}
+			break;
+
+			case scgms::NParameter_Type::ptNull:
+				break;
+
+			default:
+				rc = E_INVALIDARG;
+				break;
+		}
+
+		return Succeeded(rc) ? S_OK : E_INVALIDARG;
+	}
+}
+
+
+HRESULT Compile_Chain_Configuration(scgms::IFilter_Chain_Configuration *configuration, const uint64_t source_hash, std::vector<uint8_t> &binary, refcnt::Swstr_list &error_description) {
+	if (!configuration)
+		return E_INVALIDARG;
+
+	scgms::IFilter_Configuration_Link **link_begin, **link_end;
+	HRESULT rc = configuration->get(&link_begin, &link_end);
+	if (rc != S_OK)
+		return rc;
+
+	binary.clear();
+	binary_chain::CWriter writer{ binary };
+
+	writer.Write_U32(binary_chain::Magic);
+	writer.Write_U16(binary_chain::Version);
+	writer.Write_U16(0);
+	writer.Write_U64(source_hash);
+	const size_t filters_hash_offset = binary.size();
+	writer.Write_U64(0);		//patched below, once the descriptors are resolved
+	writer.Write_U32(static_cast<uint32_t>(std::distance(link_begin, link_end)));
+
+	uint64_t filters_hash = binary_chain::Hash_Basis;
+
+	bool compiled_all = true;
+	for (auto link = link_begin; link != link_end; link++) {
+		GUID filter_id = Invalid_GUID;
+		scgms::TFilter_Descriptor desc = scgms::Null_Filter_Descriptor;
+		if (((*link)->Get_Filter_Id(&filter_id) != S_OK) || !scgms::get_filter_descriptor_by_id(filter_id, desc)) {
+			error_description.push((dsCannot_Resolve_Filter_Descriptor + GUID_To_WString(filter_id)).c_str());
+			return E_FAIL;
+		}
+		filters_hash = binary_chain::Hash_Descriptor(desc, filters_hash);
+
+		scgms::IFilter_Parameter **param_begin, **param_end;
+		if ((*link)->get(&param_begin, &param_end) != S_OK)
+			param_begin = param_end = nullptr;
+
+		writer.Write_GUID(filter_id);
+		const size_t count_offset = binary.size();
+		writer.Write_U16(0);		//patched below, as we skip the parameters unknown to the descriptor
+
+		uint16_t written_count = 0;
+		for (auto param = param_begin; param != param_end; param++) {
+			wchar_t *config_name = nullptr;
+			if ((*param)->Get_Config_Name(&config_name) != S_OK)
+				continue;
+
+			size_t desc_idx = 0;
+			while ((desc_idx < desc.parameters_count) && (wcscmp(desc.config_parameter_name[desc_idx], config_name) != 0))
+				desc_idx++;
+
+			if (desc_idx >= desc.parameters_count)
+				continue;
+
+			const size_t record_offset = binary.size();
+			writer.Write_U16(static_cast<uint16_t>(desc_idx));
+			writer.Write_U8(static_cast<uint8_t>(desc.parameter_type[desc_idx]));
+			if (Write_Parameter_Value(writer, *param, desc.parameter_type[desc_idx]) == S_OK)
+				written_count++;
+			else {
+				binary.resize(record_offset);
+				compiled_all = false;
+
+				std::wstring error_desc = dsMalformed_Filter_Parameter_Value;
+				error_desc.append(desc.description);
+				error_desc.append(L" (2)");
+				error_desc.append(desc.ui_parameter_name[desc_idx]);
+				error_desc.append(L" (3)");
+				error_description.push(error_desc.c_str());
+			}
+		}
+
+		binary[count_offset] = static_cast<uint8_t>(written_count);
+		binary[count_offset + 1] = static_cast<uint8_t>(written_count >> 8);
+	}
+
+	for (size_t i = 0; i < sizeof(filters_hash); i++)
+		binary[filters_hash_offset + i] = static_cast<uint8_t>(filters_hash >> (8 * i));
+
+	return compiled_all ? S_OK : S_FALSE;
+}
@@ -0,0 +1,132 @@
+/**
+ * SmartCGMS - continuous glucose monitoring and controlling framework
+ * https://diabetes.zcu.cz/
+ *
+ * Copyright (c) since 2018 University of West Bohemia.
+ *
+ * Contact:
+ * diabetes@mail.kiv.zcu.cz
+ * Medical Informatics, Department of Computer Science and Engineering
+ * Faculty of Applied Sciences, University of West Bohemia
+ * Univerzitni 8, 301 00 Pilsen
+ * Czech Republic
+ * 
+ * 
+ * Purpose of this software:
+ * This software is intended to demonstrate work of the diabetes.zcu.cz research
+ * group to other scientists, to complement our published papers. It is strictly
+ * prohibited to use this software for diagnosis or treatment of any medical condition,
+ * without obtaining all required approvals from respective regulatory bodies.
+ *
+ * Especially, a diabetic patient is warned that unauthorized use of this software
+ * may result into severe injure, including death.
+ *
+ *
+ * Licensing terms:
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * a) This file is available under the Apache License, Version 2.0.
+ * b) When publishing any derivative work or results obtained using this software, you agree to cite the following paper:
+ *    Tomas Koutny and Martin Ubl, "SmartCGMS as a Testbed for a Blood-Glucose Level Prediction and/or 
+ *    Control Challenge with (an FDA-Accepted) Diabetic Patient Simulation", Procedia Computer Science,  
+ *    Volume 177, pp. 354-362, 2020
+ */
+
+#pragma once
+
+#include <scgms/iface/FilterIface.h>
+#include <scgms/iface/UIIface.h>
+#include <scgms/rtl/referencedImpl.h>
+
+#include <vector>
+#include <string>
+
+class CFilter_Parameter;
+
+//Precompiled chain configuration. The chain INI is compiled at build time (see tools/compile_chain.cpp),
+//so that the device constructs the configuration without the text parsing of Load_From_Memory.
+//The tool emits either this binary form, or scgms::TChain_Table arrays decoded from it.
+//
+//All numbers are little-endian and unaligned; strings are UTF-8 without the terminating zero.
+//  header:		magic u32, version u16, reserved u16, source hash u64, filters hash u64, link count u32
+//  link:		filter id (Data1 u32, Data2 u16, Data3 u16, Data4 u8[8]), parameter count u16
+//  parameter:	descriptor parameter index u16, parameter type u8, value encoding u8, payload
+//  payload:	Value - ptDouble, ptRatTime f64; ptInt64, ptSubject_Id i64; ptBool u8; GUID types as the filter id;
+//						ptWChar_Array length u32 + string; ptDouble_Array, ptInt64_Array count u32 + f64[] or i64[]; ptNull none
+//				Variable - length u32 + name of the variable, which forms the whole value
+//				Text - length u32 + the original value, for arrays with nested variables only
+namespace binary_chain {
+
+	constexpr uint32_t Magic = 0x43474353;		//"SCGC"
+	constexpr uint16_t Version = 2;
+
+	using NValue_Encoding = scgms::NParameter_Value_Encoding;
+
+	struct THeader {
+		uint32_t magic = 0;
+		uint16_t version = 0;
+		uint64_t source_hash = 0;		//of the INI text the binary was compiled from
+		uint64_t filters_hash = 0;		//of the descriptors of the linked filters, as the parameters refer to them by the index
+		uint32_t link_count = 0;
+	};
+
+	//64-bit FNV-1a; the hash of the preceding data continues it
+	constexpr uint64_t Hash_Basis = 14695981039346656037ULL;
+	uint64_t Hash_Source(const char *memory, const size_t len, const uint64_t hash = Hash_Basis) noexcept;
+	//the id, and the config names and types of the parameters
+	uint64_t Hash_Descriptor(const scgms::TFilter_Descriptor &desc, const uint64_t hash) noexcept;
+
+	class CWriter {
+	protected:
+		std::vector<uint8_t> &mBinary;
+	public:
+		CWriter(std::vector<uint8_t> &binary) : mBinary(binary) {};
+
+		void Write_U8(const uint8_t value);
+		void Write_U16(const uint16_t value);
+		void Write_U32(const uint32_t value);
+		void Write_U64(const uint64_t value);
+		void Write_Double(const double value);
+		void Write_GUID(const GUID &value);
+		void Write_String(const std::wstring &value);
+	};
+
+	//each read sets the reader invalid, once it would cross the end of the binary; the readers then return zeros
+	class CReader {
+	protected:
+		const uint8_t *mBegin, *mCurrent, *mEnd;
+		bool mValid = true;
+
+		bool Ensure(const size_t count) noexcept;
+	public:
+		CReader(const uint8_t *binary, const size_t len) noexcept : mBegin(binary), mCurrent(binary), mEnd(binary + len) {};
+
+		bool Valid() const noexcept { return mValid; }
+		bool At_End() const noexcept { return mCurrent == mEnd; }
+		size_t Offset() const noexcept { return static_cast<size_t>(mCurrent - mBegin); }
+		size_t Remaining() const noexcept { return static_cast<size_t>(mEnd - mCurrent); }
+
+		uint8_t Read_U8() noexcept;
+		uint16_t Read_U16() noexcept;
+		uint32_t Read_U32() noexcept;
+		uint64_t Read_U64() noexcept;
+		double Read_Double() noexcept;
+		GUID Read_GUID() noexcept;
+		std::wstring Read_String();
+	};
+
+	bool Read_Header(CReader &reader, THeader &header) noexcept;	//false, if the magic or version does not match
+
+	//reads one parameter record into the parameter; nullptr parameter just skips the record
+	//returns E_INVALIDARG, if the record is malformed, or the parameter rejects the value
+	HRESULT Read_Parameter_Value(CReader &reader, const scgms::NParameter_Type type, const NValue_Encoding encoding, CFilter_Parameter *parameter);
+
+	//the same for a ROM-resident table entry; the arrays are copied, the strings are widened only
+	HRESULT Set_Parameter_Value(const scgms::TParameter_Entry &entry, CFilter_Parameter *parameter);
+}
+
+//Compiles an already loaded configuration into the binary form; the parameters are matched against the filter descriptors,
+//hence the binary has to be loaded with the same set of the filters, as it was compiled with.
+HRESULT Compile_Chain_Configuration(scgms::IFilter_Chain_Configuration *configuration, const uint64_t source_hash, std::vector<uint8_t> &binary, refcnt::Swstr_list &error_description);
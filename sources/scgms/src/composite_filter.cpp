@@ -36,6 +36,10 @@
 
 #include "composite_filter.h"
 #include "device_event.h"
+#include "startup_profiler.h"
+#include "binary_chain_configuration.h"
+#include "intern_pool.h"
+#include "worker_pool.h"
 #if defined(EMBEDDED)
 #include <filters/generated/filters.h>
 #elif
@@ -48,8 +52,141 @@
 #include <scgms/rtl/hresult.h>
 
 #include <map>
+#include <algorithm>
 #include <stdexcept>
 
+namespace {
+	//fingerprint of the parameters, to tell whether a filter needs to be re-configured
+	//the values are hashed as parsed and written back, so that it does not matter whether a link is hashed before or after
+	//being configured, nor how the value was spelled - e.g.; 1.50 and 1.5, or a lowercase GUID, give the same fingerprint
+	uint64_t Hash_Link_Configuration(scgms::IFilter_Configuration_Link *link) {
+		std::wstring text;
+
+		scgms::IFilter_Parameter **param_begin, **param_end;
+		if (link->get(&param_begin, &param_end) == S_OK) {
+			for (auto param_iter = param_begin; param_iter != param_end; param_iter++) {
+				wchar_t *config_name = nullptr;
+				if (((*param_iter)->Get_Config_Name(&config_name) == S_OK) && config_name)
+					text += config_name;
+				text += L'=';
+
+				HRESULT rc;
+				scgms::SFilter_Parameter parameter = refcnt::make_shared_reference_ext<scgms::SFilter_Parameter, scgms::IFilter_Parameter>(*param_iter, true);
+				const std::wstring interpreted = parameter.as_wstring(rc, true);	//parses the loaded text, unless done already
+				const std::wstring value = parameter.as_wstring(rc, false);		//the malformed one stays as loaded
+				text += value;
+				if (value.find(L"$(") != std::wstring::npos) {
+					//a changed variable changes the value too
+					text += L'=';
+					text += interpreted;
+				}
+				text += L'\n';
+			}
+		}
+
+		return binary_chain::Hash_Source(reinterpret_cast<const char*>(text.data()), text.size() * sizeof(wchar_t));
+	}
+
+	//the feedback channels are wired once per chain build
+	bool Is_Feedback_Filter(scgms::IFilter *filter) {
+		scgms::SFilter_Feedback_Receiver receiver;
+		refcnt::Query_Interface<scgms::IFilter, scgms::IFilter_Feedback_Receiver>(filter, scgms::IID_Filter_Feedback_Receiver, receiver);
+		refcnt::SReferenced<scgms::IFilter_Feedback_Sender> sender;
+		refcnt::Query_Interface<scgms::IFilter, scgms::IFilter_Feedback_Sender>(filter, scgms::IID_Filter_Feedback_Sender, sender);
+
+		return receiver || sender;
+	}
+
+	//describes the elided filter, if the headless profile does not instantiate it
+	bool Elide_Filter(const GUID &filter_id, const size_t link_position, refcnt::Swstr_list &elided_filters) {
+		scgms::TFilter_Descriptor desc = scgms::Null_Filter_Descriptor;
+		if (!scgms::get_filter_descriptor_by_id(filter_id, desc) || ((desc.flags & scgms::NFilter_Flags::Presentation_Only) == scgms::NFilter_Flags::None))
+			return false;
+
+		std::wstring elided_str{ dsPresentation_Only_Filter_Elided };
+		elided_str += GUID_To_WString(filter_id);
+		elided_str += L"; filter zero-indexed position: ";
+		elided_str += std::to_wstring(link_position);
+		elided_str += L" \"";
+		elided_str += desc.description;
+		elided_str += L'"';
+		elided_filters.push(elided_str);
+		return true;
+	}
+
+	//parses the loaded values as CPersistent_Chain_Configuration::Validate does, i.e.; without instantiating the filter
+	bool Validate_Link_Parameters(scgms::IFilter_Configuration_Link *link, const GUID &filter_id, refcnt::Swstr_list &error_description) {
+		scgms::IFilter_Parameter **param_begin, **param_end;
+		if (link->get(&param_begin, &param_end) != S_OK)
+			return true;
+
+		scgms::TFilter_Descriptor desc = scgms::Null_Filter_Descriptor;
+		scgms::get_filter_descriptor_by_id(filter_id, desc);
+
+		bool all_valid = true;
+		for (auto param_iter = param_begin; param_iter != param_end; param_iter++) {
+			if ((*param_iter)->Validate() == S_OK)
+				continue;
+
+			all_valid = false;
+
+			wchar_t* config_name = nullptr;
+			(*param_iter)->Get_Config_Name(&config_name);
+			const wchar_t* ui_name = config_name;
+			for (size_t i = 0; i < desc.parameters_count; i++)
+				if (config_name && (wcscmp(desc.config_parameter_name[i], config_name) == 0)) {
+					ui_name = desc.ui_parameter_name[i];
+					break;
+				}
+
+			HRESULT rc;
+			scgms::SFilter_Parameter parameter = refcnt::make_shared_reference_ext<scgms::SFilter_Parameter, scgms::IFilter_Parameter>(*param_iter, true);
+
+			std::wstring error_desc = dsMalformed_Filter_Parameter_Value;
+			error_desc.append(desc.description ? desc.description : GUID_To_WString(filter_id).c_str());
+			error_desc.append(L" (2)");
+			error_desc.append(ui_name ? ui_name : L"");
+			error_desc.append(L" (3)");
+			error_desc.append(parameter.as_wstring(rc, false));
+			error_description.push(error_desc.c_str());
+		}
+
+		return all_valid;
+	}
+
+	bool Is_Independent_Configure(const GUID &filter_id) {
+		scgms::TFilter_Descriptor desc = scgms::Null_Filter_Descriptor;
+		return scgms::get_filter_descriptor_by_id(filter_id, desc) && ((desc.flags & scgms::NFilter_Flags::Independent_Configure) != scgms::NFilter_Flags::None);
+	}
+
+	//describe such an event anyway just in the case the filter would not do so - hence we would at least know the configuration-failing filter
+	void Describe_Configure_Failure(const GUID &filter_id, const size_t link_position, const HRESULT rc, refcnt::Swstr_list &error_description) {
+		std::wstring err_str{dsFailed_to_configure_filter};
+		err_str += GUID_To_WString(filter_id);
+		err_str += L"; filter zero-indexed position: ";
+		err_str += std::to_wstring(link_position);
+		
+		bool failed_to_resolve_descriptor = false;
+		{//try to obtain filter's name
+			scgms::TFilter_Descriptor desc = scgms::Null_Filter_Descriptor;
+			if (scgms::get_filter_descriptor_by_id(filter_id, desc) ) {
+				err_str += L" \"";
+				err_str += desc.description;
+				err_str += L'"';
+			}
+			else
+				failed_to_resolve_descriptor = true;
+		}
+		error_description.push(err_str.c_str());
+
+		if (failed_to_resolve_descriptor)
+			describe_loaded_filters(error_description);
+
+		err_str = dsLast_RC + std::wstring{ Describe_Error(rc) };
+		error_description.push(err_str.c_str());
+	}
+}
+
 #if defined(FREERTOS) || defined (WASM)
 CComposite_Filter::CComposite_Filter() noexcept {
 	//
@@ -60,7 +197,125 @@ CComposite_Filter::CComposite_Filter(std::recursive_mutex &communication_guard)
 }
 #endif
 
-HRESULT CComposite_Filter::Build_Filter_Chain(scgms::IFilter_Chain_Configuration *configuration, scgms::IFilter *next_filter, scgms::TOn_Filter_Created on_filter_created, const void* on_filter_created_data, refcnt::Swstr_list& error_description) noexcept {
+std::unique_ptr<CFilter_Executor> CComposite_Filter::Make_Executor(const GUID &filter_id, scgms::IFilter *next_filter) {
+#if defined(ESP32)
+	return std::make_unique<CFilter_Executor>(filter_id, mCommunication_Guard, mFeedback_Channels, next_filter, mOn_Filter_Created, mOn_Filter_Created_Data);
+#elif defined(FREERTOS) || defined(WASM)
+	return std::make_unique<CFilter_Executor>(filter_id, mFeedback_Channels, next_filter, mOn_Filter_Created, mOn_Filter_Created_Data);
+#endif
+}
+
+void CComposite_Filter::Send_Shut_Down() noexcept {
+	if (mExecutors.empty())
+		return;
+
+	scgms::IDevice_Event* shutdown_event = allocate_device_event( scgms::NDevice_Event_Code::Shut_Down );
+	if (shutdown_event)
+		mExecutors[0]->Execute(shutdown_event);
+}
+
+#if defined(ESP32)
+HRESULT CComposite_Filter::Create_Filters_Concurrently(scgms::IFilter_Configuration_Link **link_begin, scgms::IFilter_Configuration_Link **link_end, scgms::IFilter *next_filter, const bool elide_presentation_only, refcnt::Swstr_list &error_description, refcnt::Swstr_list &elided_filters) noexcept {
+	struct TPlanned_Filter {
+		scgms::IFilter_Configuration_Link *link;
+		GUID filter_id;
+		size_t link_position;
+		bool independent;
+		HRESULT rc;
+		refcnt::Swstr_list error_description;	//of an independent filter, merged in the chain order
+	};
+
+	//reported from the last filter, as with the sequential build
+	std::vector<TPlanned_Filter> filters;
+	for (size_t link_position = std::distance(link_begin, link_end); link_position-- > 0; ) {
+		scgms::IFilter_Configuration_Link *link = link_begin[link_position];
+
+		GUID filter_id;
+		const HRESULT rc = link->Get_Filter_Id(&filter_id);
+		if (rc != S_OK) {
+			error_description.push(dsCannot_read_filter_id);
+			return rc;
+		}
+
+		if (elide_presentation_only && Elide_Filter(filter_id, link_position, elided_filters))
+			continue;
+
+		filters.push_back(TPlanned_Filter{ link, filter_id, link_position, Is_Independent_Configure(filter_id), E_FAIL, refcnt::Swstr_list{} });
+	}
+	std::reverse(filters.begin(), filters.end());
+
+	//the executors exist before any filter does, so that every filter gets its successor regardless of the creation order
+	for (size_t i = 0; i < filters.size(); i++) {
+		std::unique_ptr<CFilter_Executor> executor = Make_Executor(Invalid_GUID, nullptr);
+		if (!executor) {
+			mExecutors.clear();
+			return E_OUTOFMEMORY;
+		}
+
+		mExecutors.push_back(std::move(executor));
+	}
+
+	auto successor = [this, &filters, next_filter](const size_t index) -> scgms::IFilter* {
+		return index + 1 < filters.size() ? mExecutors[index + 1].get() : next_filter;
+	};
+
+	std::vector<size_t> independent;
+	for (size_t i = 0; i < filters.size(); i++)
+		if (filters[i].independent)
+			independent.push_back(i);
+
+	//the independent filters do not send anything while being configured => their successors do not have to exist yet
+	//on_filter_created is called later on, by this thread and in the chain order
+	const size_t thread_count = std::min<size_t>(independent.size(), std::thread::hardware_concurrency());
+	if (thread_count > 1) {
+		CWorker_Pool worker_pool{ thread_count };
+		worker_pool.Parallel_For(independent.size(), [&](const size_t index) {
+			const size_t position = independent[index];
+			TPlanned_Filter &filter = filters[position];
+
+			mExecutors[position]->Create_Filter(filter.filter_id, successor(position));
+			SCGMS_STARTUP_PHASE(Configure, filter.filter_id);
+			filter.rc = mExecutors[position]->Reconfigure(filter.link, filter.error_description.get());
+		});
+	}
+	else
+		for (const size_t position : independent)
+			filters[position].independent = false;	//not worth the threads
+
+	//the rest goes from the last filter, so that the dependent filters can send events through the configured ones
+	for (size_t i = filters.size(); i-- > 0; ) {
+		TPlanned_Filter &filter = filters[i];
+		CFilter_Executor &executor = *mExecutors[i];
+
+		HRESULT rc;
+		if (filter.independent) {
+			filter.error_description.for_each([&error_description](const std::wstring &str) { error_description.push(str); });
+			rc = filter.rc == S_OK ? executor.Filter_Created() : filter.rc;
+		}
+		else {
+			executor.Create_Filter(filter.filter_id, successor(i));
+			SCGMS_STARTUP_PHASE(Configure, filter.filter_id);
+			rc = executor.Configure(filter.link, error_description.get());
+		}
+
+		if (!Succeeded(rc)) {
+			//this filter and those before it go first, then the already configured ones get the shut down
+			//the independent filters before this one have been configured, but no event could have started them yet
+			mExecutors.erase(mExecutors.begin(), mExecutors.begin() + i + 1);
+			Describe_Configure_Failure(filter.filter_id, filter.link_position, rc, error_description);
+			Send_Shut_Down();
+			mExecutors.clear();
+			return rc;
+		}
+
+		executor.Set_Configuration_Hash(Hash_Link_Configuration(filter.link));
+	}
+
+	return S_OK;
+}
+#endif
+
+HRESULT CComposite_Filter::Build_Filter_Chain(scgms::IFilter_Chain_Configuration *configuration, scgms::IFilter *next_filter, const scgms::NExecution_Flags execution_flags, scgms::TOn_Filter_Created on_filter_created, const void* on_filter_created_data, refcnt::Swstr_list& error_description, refcnt::Swstr_list& elided_filters) noexcept {
 	mRefuse_Execute = true;
 	if (!mExecutors.empty())
 		return E_ILLEGAL_METHOD_CALL;	//so far, we are able to configure the chain just once
@@ -70,6 +325,11 @@ HRESULT CComposite_Filter::Build_Filter_Chain(scgms::IFilter_Chain_Configuration
 #if defined(ESP32)
 	std::lock_guard<std::recursive_mutex> guard{ mCommunication_Guard };
 #endif
+	mNext_Filter = next_filter;
+	mExecution_Flags = execution_flags;
+	mOn_Filter_Created = on_filter_created;
+	mOn_Filter_Created_Data = on_filter_created_data;
+
 	scgms::IFilter *last_filter = next_filter;
 		
 	scgms::IFilter_Configuration_Link **link_begin, **link_end;
@@ -81,19 +341,21 @@ HRESULT CComposite_Filter::Build_Filter_Chain(scgms::IFilter_Chain_Configuration
 
 	//we have to create the filter executors from the last one
 	{
-		auto send_shut_down = [this]() {
-			if (mExecutors.empty())
-				return;
+		size_t link_position = std::distance(link_begin, link_end);
+		const bool elide_presentation_only = (execution_flags & scgms::NExecution_Flags::Elide_Presentation_Only) != scgms::NExecution_Flags::None;
 
-			scgms::IDevice_Event* shutdown_event = allocate_device_event( scgms::NDevice_Event_Code::Shut_Down );
-			if (shutdown_event)
-				mExecutors[0]->Execute(shutdown_event);
-		};
+#if defined(ESP32) && !defined(SCGMS_SINGLE_THREADED_REFCNT)
+		if ((execution_flags & scgms::NExecution_Flags::Parallel_Build) != scgms::NExecution_Flags::None) {
+			rc = Create_Filters_Concurrently(link_begin, link_end, next_filter, elide_presentation_only, error_description, elided_filters);
+			if (!Succeeded(rc))
+				return rc;	//already torn down
 
-		size_t link_position = std::distance(link_begin, link_end);
+			link_end = link_begin;	//all the filters have been created
+		}
+#endif
 
 		//1st round - create the filters
-		do {
+		while (link_end != link_begin) {
 			link_position--;
 
 			//scgms::IFilter_Configuration_Link* &link = *(link_end-1);	-- let's increase its ref count safely, because we are working with it
@@ -103,56 +365,39 @@ HRESULT CComposite_Filter::Build_Filter_Chain(scgms::IFilter_Chain_Configuration
 			rc = link->Get_Filter_Id(&filter_id);
 			if (rc != S_OK) {
 				error_description.push(dsCannot_read_filter_id);
-				send_shut_down();
+				Send_Shut_Down();
 				mExecutors.clear();
 				return rc;
 			}
-#if defined(ESP32)
-			std::unique_ptr<CFilter_Executor> new_executor = std::make_unique<CFilter_Executor>(filter_id, mCommunication_Guard, last_filter, on_filter_created, on_filter_created_data);
-#elif defined(FREERTOS) || defined(WASM)
-			std::unique_ptr<CFilter_Executor> new_executor = std::make_unique<CFilter_Executor>(filter_id, last_filter, on_filter_created, on_filter_created_data);
-#endif
+
+			if (elide_presentation_only && Elide_Filter(filter_id, link_position, elided_filters)) {
+				//do not instantiate the filter at all - the previous one gets linked directly to last_filter
+				link_end--;
+				continue;
+			}
+
+			std::unique_ptr<CFilter_Executor> new_executor = Make_Executor(filter_id, last_filter);
 			//try to configure the filter 
 			if (!new_executor) {
-				send_shut_down();
+				Send_Shut_Down();
 				mExecutors.clear();
 				return E_OUTOFMEMORY;
 			}
 
 
-			rc = new_executor->Configure(link.get(), error_description.get());
+			{
+				SCGMS_STARTUP_PHASE(Configure, filter_id);
+				rc = new_executor->Configure(link.get(), error_description.get());
+			}
 			if (!Succeeded(rc)) {
 				//if failed, we need to delete this, newly constructed filter first,
 				//i.e., before clearing mExecutors because it is tied to resources,
 				//which must be released AFTER destroying this filter
 				new_executor.reset(nullptr);
 
-				//describe such an event anyway just in the case the filter would not do so - hence we would at least know the configuration-failing filter
-				std::wstring err_str{dsFailed_to_configure_filter};
-				err_str += GUID_To_WString(filter_id);
-				err_str += L"; filter zero-indexed position: ";
-				err_str += std::to_wstring(link_position);
-				
-				bool failed_to_resolve_descriptor = false;
-				{//try to obtain filter's name
-					scgms::TFilter_Descriptor desc = scgms::Null_Filter_Descriptor;
-					if (scgms::get_filter_descriptor_by_id(filter_id, desc) ) {
-						err_str += L" \"";
-						err_str += desc.description;
-						err_str += L'"';
-					}
-					else
-						failed_to_resolve_descriptor = true;
-				}
-				error_description.push(err_str.c_str());
+				Describe_Configure_Failure(filter_id, link_position, rc, error_description);
 
-				if (failed_to_resolve_descriptor)
-					describe_loaded_filters(error_description);
-
-				err_str = dsLast_RC + std::wstring{ Describe_Error(rc) };
-				error_description.push(err_str.c_str());
-
-				send_shut_down();
+				Send_Shut_Down();
 				
 				mExecutors.clear();
 
@@ -160,27 +405,33 @@ HRESULT CComposite_Filter::Build_Filter_Chain(scgms::IFilter_Chain_Configuration
 			}
 
 			//filter is configured, insert it into the chain
+			new_executor->Set_Configuration_Hash(Hash_Link_Configuration(link.get()));
 			last_filter = new_executor.get();
 			mExecutors.insert(mExecutors.begin(), std::move(new_executor));
 			
 			link_end--;
-		} while (link_end != link_begin);
+		}
+
+		SCGMS_STARTUP_PHASE(Feedback_Wiring);
 
 		//2nd round - gather information about the feedback receivers
-		std::map<std::wstring, scgms::SFilter_Feedback_Receiver> feedback_map;
+		//the names are interned, so that the senders are matched by pointers
+		std::map<intern_pool::TString, scgms::SFilter_Feedback_Receiver> feedback_map;
 		for (auto &possible_receiver : mExecutors) {
 			scgms::SFilter_Feedback_Receiver feedback_receiver;
 			refcnt::Query_Interface<scgms::IFilter, scgms::IFilter_Feedback_Receiver>(possible_receiver.get(), scgms::IID_Filter_Feedback_Receiver, feedback_receiver);
 			if (feedback_receiver) {
 				wchar_t *name;
 				if (feedback_receiver->Name(&name) == S_OK) {
-					feedback_map[name] = feedback_receiver;
+					feedback_map[intern_pool::Intern(name)] = feedback_receiver;
 				}
 			}
 		}
 
 		//3nd round - set the receivers to the senders
 		//multiple senders can connect to a single receiver (so that we can have a single feedback filter)
+		//senders do not get the receiver itself, but its queue - the feedback is delivered once the current event has passed the chain
+		std::map<intern_pool::TString, CFeedback_Queue*> feedback_queues;
 		if (!feedback_map.empty())
 			for (auto &possible_sender : mExecutors) {
 				refcnt::SReferenced<scgms::IFilter_Feedback_Sender> feedback_sender;
@@ -189,16 +440,21 @@ HRESULT CComposite_Filter::Build_Filter_Chain(scgms::IFilter_Chain_Configuration
 					wchar_t *name;
 					if (feedback_sender->Name(&name) == S_OK) {
 
-						auto feedback_receiver = feedback_map.find(name);
+						auto feedback_receiver = feedback_map.find(intern_pool::Find(name));
 						if (feedback_receiver != feedback_map.end()) {
-							feedback_sender->Sink(feedback_receiver->second.get());
+							CFeedback_Queue* &feedback_queue = feedback_queues[feedback_receiver->first];
+							if (!feedback_queue)
+								feedback_queue = mFeedback_Channels.Add_Receiver(feedback_receiver->second.get());
+							feedback_sender->Sink(feedback_queue);
 						}
 						else {
 							std::wstring err_str{ dsFeedback_sender_not_connected };
 							err_str += name;
 							error_description.push(err_str.c_str());
-							send_shut_down();
+							Send_Shut_Down();
+							mFeedback_Channels.Close();
 							mExecutors.clear();
+							mFeedback_Channels.Clear();
 							return E_FAIL;	//this is very likely severe error in the configuration, hence we stop it
 						}
 					}
@@ -210,9 +466,239 @@ HRESULT CComposite_Filter::Build_Filter_Chain(scgms::IFilter_Chain_Configuration
 	return S_OK;
 }
 
+HRESULT CComposite_Filter::Reconfigure(scgms::IFilter_Chain_Configuration *configuration, refcnt::Swstr_list& error_description) noexcept {
+	if (!configuration) return E_INVALIDARG;
+	if (Empty()) return E_ILLEGAL_METHOD_CALL;	//nothing to diff against, the chain has to be built
+
+	scgms::IFilter_Configuration_Link **link_begin, **link_end;
+	HRESULT rc = configuration->get(&link_begin, &link_end);
+	if (rc != S_OK) {
+		error_description.push(dsCannot_read_configuration);
+		return rc;
+	}
+
+	//the links, which Build_Filter_Chain would instantiate
+	struct TLink_State {
+		GUID filter_id;
+		scgms::IFilter_Configuration_Link *link;
+		uint64_t hash;
+	};
+
+	std::vector<TLink_State> links;
+	const bool elide_presentation_only = (mExecution_Flags & scgms::NExecution_Flags::Elide_Presentation_Only) != scgms::NExecution_Flags::None;
+	for (auto link_iter = link_begin; link_iter != link_end; link_iter++) {
+		GUID filter_id;
+		if ((*link_iter)->Get_Filter_Id(&filter_id) != S_OK) {
+			error_description.push(dsCannot_read_filter_id);
+			return E_FAIL;
+		}
+
+		if (elide_presentation_only) {
+			scgms::TFilter_Descriptor desc = scgms::Null_Filter_Descriptor;
+			if (scgms::get_filter_descriptor_by_id(filter_id, desc) && ((desc.flags & scgms::NFilter_Flags::Presentation_Only) != scgms::NFilter_Flags::None))
+				continue;
+		}
+
+		links.push_back(TLink_State{ filter_id, *link_iter, Hash_Link_Configuration(*link_iter) });
+	}
+
+	if (link_begin == link_end)
+		return E_INVALIDARG;
+
+	//the unchanged beginning and end of the chain stay as they are, the filters in between get replaced
+	const size_t old_count = mExecutors.size();
+	const size_t new_count = links.size();
+	size_t prefix = 0;
+	while ((prefix < old_count) && (prefix < new_count) && (mExecutors[prefix]->Filter_Id() == links[prefix].filter_id))
+		prefix++;
+	size_t suffix = 0;
+	while ((prefix + suffix < old_count) && (prefix + suffix < new_count) && (mExecutors[old_count - suffix - 1]->Filter_Id() == links[new_count - suffix - 1].filter_id))
+		suffix++;
+
+	const bool structure_changed = (prefix != old_count) || (prefix != new_count);
+	//a filter keeps the executor of its successor, which can be given a different filter - unlike the chain's next filter
+	//=> when appending or removing at the end, the last unchanged filter has to be re-created too
+	//with all the filters elided, there is no filter to re-create, though
+	if (structure_changed && (suffix == 0) && (prefix > 0) && ((prefix == old_count) || (prefix == new_count)))
+		prefix--;
+
+	const size_t old_middle = old_count - prefix - suffix;
+	const size_t new_middle = new_count - prefix - suffix;
+
+	//a kept filter gets the changed parameters in-place, so that it keeps its state
+	//=> the values are parsed first, so that a malformed one leaves the running chain intact
+	const bool structure_kept = !structure_changed;
+	auto is_kept = [&](const size_t i) { return structure_kept || (i < prefix) || (i >= prefix + new_middle); };
+	auto old_position = [&](const size_t i) { return i < prefix ? i : i + old_count - new_count; };
+	for (size_t i = 0; i < new_count; i++) {
+		if (!is_kept(i) || (mExecutors[old_position(i)]->Configuration_Hash() == links[i].hash))
+			continue;
+
+		if (!Validate_Link_Parameters(links[i].link, links[i].filter_id, error_description))
+			return E_INVALIDARG;
+	}
+
+	bool rebuild = false;
+	for (size_t i = prefix; i < prefix + old_middle; i++)
+		rebuild |= Is_Feedback_Filter(mExecutors[i].get());
+
+	//create and configure the new filters first, so that a failure leaves the running chain intact
+	//until they make it into the chain, what they send goes nowhere - the last one sends to the executor, which gets
+	//the first filter of the unchanged end, or to the chain's output, which opens once they are in
+	std::unique_ptr<CChain_Output> output;			//these two outlive the created filters, which send to them
+	std::unique_ptr<CFilter_Executor> relocated;
+	std::vector<std::unique_ptr<CFilter_Executor>> created;
+	if (structure_changed && !rebuild && (new_middle > 0)) {
+		scgms::IFilter *successor;
+		if (suffix > 0) {
+			relocated = Make_Executor(Invalid_GUID, nullptr);
+			successor = relocated.get();
+		}
+		else {
+			output = std::make_unique<CChain_Output>(mNext_Filter);
+			successor = output.get();
+		}
+
+		for (size_t i = prefix + new_middle; i-- > prefix; ) {
+			std::unique_ptr<CFilter_Executor> new_executor = Make_Executor(links[i].filter_id, successor);
+			if (!new_executor)
+				return E_OUTOFMEMORY;
+
+			rebuild |= Is_Feedback_Filter(new_executor.get());
+			successor = new_executor.get();
+			created.insert(created.begin(), std::move(new_executor));
+		}
+
+		//a feedback filter is known before it gets configured, so that the rebuild does not configure it twice
+		if (!rebuild) {
+			for (size_t i = created.size(); i-- > 0; ) {
+				rc = created[i]->Configure(links[prefix + i].link, error_description.get());
+				if (!Succeeded(rc)) {
+					std::wstring err_str{ dsFailed_to_configure_filter };
+					err_str += GUID_To_WString(links[prefix + i].filter_id);
+					err_str += L"; filter zero-indexed position: ";
+					err_str += std::to_wstring(prefix + i);
+					error_description.push(err_str.c_str());
+
+					//the filters configured already terminate as with Build_Filter_Chain - the shut down does not leave them
+					created.erase(created.begin(), created.begin() + i + 1);
+					if (!created.empty()) {
+#if defined(ESP32)
+						std::lock_guard<std::recursive_mutex> guard{ mCommunication_Guard };
+#endif
+						scgms::IDevice_Event* shutdown_event = allocate_device_event(scgms::NDevice_Event_Code::Shut_Down);
+						if (shutdown_event)
+							created[0]->Execute(shutdown_event);
+					}
+					return rc;
+				}
+
+				created[i]->Set_Configuration_Hash(links[prefix + i].hash);
+			}
+		}
+	}
+
+	if (rebuild) {
+		//the feedback channels cannot be re-wired, hence it has to be the cold restart
+		created.clear();	//not configured
+		Clear();
+
+		const scgms::NExecution_Flags execution_flags = mExecution_Flags;
+		refcnt::Swstr_list elided_filters;
+		rc = Build_Filter_Chain(configuration, mNext_Filter, execution_flags, mOn_Filter_Created, mOn_Filter_Created_Data, error_description, elided_filters);
+		return Succeeded(rc) ? rc : E_ILLEGAL_STATE_CHANGE;	//the old chain is gone already
+	}
+
+#if defined(ESP32)
+	std::lock_guard<std::recursive_mutex> guard{ mCommunication_Guard };
+#endif
+
+	if (structure_changed && ((old_count == 0) || (new_count == 0))) {
+		//from or to the chain of the elided filters only, which just forwards to the next filter
+		for (auto &removed : mExecutors)
+			removed->Release_Filter();
+		mExecutors = std::move(created);
+
+		if (output) {
+			output->Open();
+			mOutput = std::move(output);
+		}
+		else
+			mOutput.reset();
+	}
+	else if (structure_changed) {
+		//the last unchanged filter of the beginning keeps the entry executor, whatever filter it gets
+		CFilter_Executor &entry = *mExecutors[prefix];
+		std::vector<std::unique_ptr<CFilter_Executor>> executors;
+		executors.reserve(new_count);
+		for (size_t i = 0; i < prefix; i++)
+			executors.push_back(std::move(mExecutors[i]));
+
+		size_t first_kept;
+		if (new_middle > 0) {
+			//the first filter of the unchanged end moves to the executor, which the new filters send to
+			if (relocated)
+				relocated->Take_Filter(*mExecutors[old_count - suffix]);
+			entry.Take_Filter(*created[0]);
+
+			executors.push_back(std::move(mExecutors[prefix]));
+			for (size_t i = 1; i < created.size(); i++)
+				executors.push_back(std::move(created[i]));
+			if (relocated)
+				executors.push_back(std::move(relocated));
+
+			first_kept = (suffix > 0) ? old_count - suffix + 1 : old_count;
+		}
+		else {
+			//removing only, the first filter of the unchanged end moves into the entry executor
+			entry.Take_Filter(*mExecutors[old_count - suffix]);
+			executors.push_back(std::move(mExecutors[prefix]));
+			first_kept = old_count - suffix + 1;
+		}
+
+		for (size_t i = first_kept; i < old_count; i++)
+			executors.push_back(std::move(mExecutors[i]));
+
+		//what has not been moved are the removed filters
+		for (auto &removed : mExecutors)
+			if (removed)
+				removed->Release_Filter();
+		mExecutors = std::move(executors);
+
+		if (output) {
+			//the removed last filter has been the only one sending to the previous output
+			output->Open();
+			mOutput = std::move(output);
+		}
+	}
+
+	//re-configure the kept filters, whose parameters have changed
+	bool changed = structure_changed;
+	for (size_t i = 0; i < new_count; i++) {
+		if (!is_kept(i) || (mExecutors[i]->Configuration_Hash() == links[i].hash))
+			continue;
+
+		rc = mExecutors[i]->Reconfigure(links[i].link, error_description.get());
+		if (!Succeeded(rc)) {
+			//the filter has refused the values, which are well-formed though; the chain keeps running with what the filter has kept
+			std::wstring err_str{ dsFailed_to_configure_filter };
+			err_str += GUID_To_WString(links[i].filter_id);
+			err_str += L"; filter zero-indexed position: ";
+			err_str += std::to_wstring(i);
+			error_description.push(err_str.c_str());
+			return rc;
+		}
+
+		mExecutors[i]->Set_Configuration_Hash(links[i].hash);
+		changed = true;
+	}
+
+	return changed ? S_OK : S_FALSE;
+}
+
 HRESULT CComposite_Filter::Execute(scgms::IDevice_Event *event) noexcept {
 	if (!event) return E_INVALIDARG;
-	if (mExecutors.empty()) {
+	if (Empty()) {
 		event->Release();
 		return S_FALSE;
 	}
@@ -225,6 +711,9 @@ HRESULT CComposite_Filter::Execute(scgms::IDevice_Event *event) noexcept {
 		return E_ILLEGAL_METHOD_CALL;
 	}
 
+	if (mExecutors.empty())
+		return mNext_Filter->Execute(event);	//all the filters have been elided
+
 	return mExecutors[0]->Execute(event);	//and by this, we delegate event's release to the filters
 }
 
@@ -239,16 +728,22 @@ HRESULT CComposite_Filter::Clear() noexcept {
 		mRefuse_Execute = true;
 	}
 
+	//undelivered feedback is discarded, so that no receiver gets called once being released
+	mFeedback_Channels.Close();
+
 	//once we refuse any communication from the Execute method, we can safely release the filters
 	//assuming that they terminate any threads they have spawned
 	for (size_t i = 0; i < mExecutors.size(); i++)
 		mExecutors[i]->Release_Filter();
 	mExecutors.clear();	//calls reset on all contained unique ptr's	
+	mOutput.reset();
+	mFeedback_Channels.Clear();
 	
 
 	return S_OK;
 }
 
 bool CComposite_Filter::Empty() const noexcept {
-	return mExecutors.empty();
+	//a built chain, whose filters have been all elided, is not empty - it forwards to the next filter
+	return mExecutors.empty() && (mRefuse_Execute || !mNext_Filter);
 }
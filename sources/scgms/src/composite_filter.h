@@ -51,7 +51,22 @@ protected:
 #if defined(ESP32)
 	std::recursive_mutex &mCommunication_Guard;		
 #endif
+	CFeedback_Channels mFeedback_Channels;		//must outlive the executors
+	std::unique_ptr<CChain_Output> mOutput;		//of the last filter, if a reconfiguration has created it; must outlive the executors too
 	std::vector<std::unique_ptr<CFilter_Executor>> mExecutors;
+
+	//what the chain has been built with, so that Reconfigure can create the filters alike
+	scgms::IFilter *mNext_Filter = nullptr;
+	scgms::NExecution_Flags mExecution_Flags = scgms::NExecution_Flags::None;
+	scgms::TOn_Filter_Created mOn_Filter_Created = nullptr;
+	const void* mOn_Filter_Created_Data = nullptr;
+
+	std::unique_ptr<CFilter_Executor> Make_Executor(const GUID &filter_id, scgms::IFilter *next_filter);
+	void Send_Shut_Down() noexcept;		//to the first filter, so that all the filters terminate
+#if defined(ESP32)
+	//Build_Filter_Chain's first round with NExecution_Flags::Parallel_Build; on failure, the filters have been torn down already
+	HRESULT Create_Filters_Concurrently(scgms::IFilter_Configuration_Link **link_begin, scgms::IFilter_Configuration_Link **link_end, scgms::IFilter *next_filter, const bool elide_presentation_only, refcnt::Swstr_list &error_description, refcnt::Swstr_list &elided_filters) noexcept;
+#endif
 public:
 #if defined(FREERTOS) || defined (WASM)
 	CComposite_Filter() noexcept;
@@ -59,7 +74,8 @@ public:
 	CComposite_Filter(std::recursive_mutex &communication_guard) noexcept;
 #endif
 
-	HRESULT Build_Filter_Chain(scgms::IFilter_Chain_Configuration *configuration, scgms::IFilter *next_filter, scgms::TOn_Filter_Created on_filter_created, const void* on_filter_created_data, refcnt::Swstr_list &error_description) noexcept;
+	HRESULT Build_Filter_Chain(scgms::IFilter_Chain_Configuration *configuration, scgms::IFilter *next_filter, const scgms::NExecution_Flags execution_flags, scgms::TOn_Filter_Created on_filter_created, const void* on_filter_created_data, refcnt::Swstr_list &error_description, refcnt::Swstr_list &elided_filters) noexcept;
+	HRESULT Reconfigure(scgms::IFilter_Chain_Configuration *configuration, refcnt::Swstr_list &error_description) noexcept;
 	HRESULT Execute(scgms::IDevice_Event *event) noexcept;
 	HRESULT Clear() noexcept;
 	bool Empty() const noexcept;
@@ -0,0 +1,141 @@
+/**
+ * SmartCGMS - continuous glucose monitoring and controlling framework
+ * https://diabetes.zcu.cz/
+ *
+ * Copyright (c) since 2018 University of West Bohemia.
+ *
+ * Contact:
+ * diabetes@mail.kiv.zcu.cz
+ * Medical Informatics, Department of Computer Science and Engineering
+ * Faculty of Applied Sciences, University of West Bohemia
+ * Univerzitni 8, 301 00 Pilsen
+ * Czech Republic
+ * 
+ * 
+ * Purpose of this software:
+ * This software is intended to demonstrate work of the diabetes.zcu.cz research
+ * group to other scientists, to complement our published papers. It is strictly
+ * prohibited to use this software for diagnosis or treatment of any medical condition,
+ * without obtaining all required approvals from respective regulatory bodies.
+ *
+ * Especially, a diabetic patient is warned that unauthorized use of this software
+ * may result into severe injure, including death.
+ *
+ *
+ * Licensing terms:
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * a) This file is available under the Apache License, Version 2.0.
+ * b) When publishing any derivative work or results obtained using this software, you agree to cite the following paper:
+ *    Tomas Koutny and Martin Ubl, "SmartCGMS as a Testbed for a Blood-Glucose Level Prediction and/or 
+ *    Control Challenge with (an FDA-Accepted) Diabetic Patient Simulation", Procedia Computer Science,  
+ *    Volume 177, pp. 354-362, 2020
+ */
+
+#include "configuration_arena.h"
+
+#include <new>
+#include <algorithm>
+
+namespace {
+	//every allocation is prefixed with the arena it came from, or nullptr if it came from the heap
+	constexpr size_t Header_Size = alignof(std::max_align_t) > sizeof(CConfiguration_Arena*) ? alignof(std::max_align_t) : sizeof(CConfiguration_Arena*);
+
+	constexpr size_t Align_Up(const size_t size) {
+		return (size + alignof(std::max_align_t) - 1) & ~(alignof(std::max_align_t) - 1);
+	}
+
+	//the loading runs on a single thread, which sets the arena; other threads keep allocating from the heap
+#if defined(ESP32)
+	thread_local CConfiguration_Arena* Current_Arena = nullptr;
+#elif defined(FREERTOS) || defined(WASM)
+	CConfiguration_Arena* Current_Arena = nullptr;
+#endif
+}
+
+CConfiguration_Arena* CConfiguration_Arena::Create() noexcept {
+	return new (std::nothrow) CConfiguration_Arena{};
+}
+
+CConfiguration_Arena::~CConfiguration_Arena() {
+	while (mBlocks) {
+		TBlock* next = mBlocks->next;
+		::operator delete(static_cast<void*>(mBlocks));
+		mBlocks = next;
+	}
+}
+
+void CConfiguration_Arena::Add_Ref() noexcept {
+	mReferences++;
+}
+
+void CConfiguration_Arena::Release() noexcept {
+	if (--mReferences == 0)
+		delete this;
+}
+
+void* CConfiguration_Arena::Allocate(const size_t size) noexcept {
+	const size_t aligned_size = Align_Up(size);
+
+	if (static_cast<size_t>(mLimit - mCursor) < aligned_size) {
+		//the rest of the current block is abandoned; large objects get a block of their own
+		const size_t block_size = std::max(Default_Block_Size, aligned_size + Align_Up(sizeof(TBlock)));
+		TBlock* block = static_cast<TBlock*>(::operator new(block_size, std::nothrow));
+		if (!block)
+			return nullptr;
+
+		block->next = mBlocks;
+		block->size = block_size;
+		mBlocks = block;
+		mCursor = reinterpret_cast<uint8_t*>(block) + Align_Up(sizeof(TBlock));
+		mLimit = reinterpret_cast<uint8_t*>(block) + block_size;
+	}
+
+	void* result = mCursor;
+	mCursor += aligned_size;
+	return result;
+}
+
+size_t CConfiguration_Arena::Reserved_Bytes() const noexcept {
+	size_t total = 0;
+	for (TBlock* block = mBlocks; block; block = block->next)
+		total += block->size;
+	return total;
+}
+
+
+void* CArena_Allocated::operator new(const size_t size) noexcept {
+	CConfiguration_Arena* arena = Current_Arena;
+	uint8_t* memory = static_cast<uint8_t*>(arena ? arena->Allocate(Header_Size + size) : ::operator new(Header_Size + size, std::nothrow));
+	if (!memory)
+		return nullptr;
+
+	*reinterpret_cast<CConfiguration_Arena**>(memory) = arena;
+	if (arena)
+		arena->Add_Ref();
+
+	return memory + Header_Size;
+}
+
+void CArena_Allocated::operator delete(void* ptr) noexcept {
+	if (!ptr)
+		return;
+
+	uint8_t* memory = static_cast<uint8_t*>(ptr) - Header_Size;
+	CConfiguration_Arena* arena = *reinterpret_cast<CConfiguration_Arena**>(memory);
+	if (arena)
+		arena->Release();	//the memory itself goes with the block
+	else
+		::operator delete(static_cast<void*>(memory));
+}
+
+
+CArena_Scope::CArena_Scope(CConfiguration_Arena* arena) noexcept : mPrevious(Current_Arena) {
+	Current_Arena = arena;
+}
+
+CArena_Scope::~CArena_Scope() noexcept {
+	Current_Arena = mPrevious;
+}
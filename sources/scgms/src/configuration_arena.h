@@ -0,0 +1,98 @@
+/**
+ * SmartCGMS - continuous glucose monitoring and controlling framework
+ * https://diabetes.zcu.cz/
+ *
+ * Copyright (c) since 2018 University of West Bohemia.
+ *
+ * Contact:
+ * diabetes@mail.kiv.zcu.cz
+ * Medical Informatics, Department of Computer Science and Engineering
+ * Faculty of Applied Sciences, University of West Bohemia
+ * Univerzitni 8, 301 00 Pilsen
+ * Czech Republic
+ * 
+ * 
+ * Purpose of this software:
+ * This software is intended to demonstrate work of the diabetes.zcu.cz research
+ * group to other scientists, to complement our published papers. It is strictly
+ * prohibited to use this software for diagnosis or treatment of any medical condition,
+ * without obtaining all required approvals from respective regulatory bodies.
+ *
+ * Especially, a diabetic patient is warned that unauthorized use of this software
+ * may result into severe injure, including death.
+ *
+ *
+ * Licensing terms:
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * a) This file is available under the Apache License, Version 2.0.
+ * b) When publishing any derivative work or results obtained using this software, you agree to cite the following paper:
+ *    Tomas Koutny and Martin Ubl, "SmartCGMS as a Testbed for a Blood-Glucose Level Prediction and/or 
+ *    Control Challenge with (an FDA-Accepted) Diabetic Patient Simulation", Procedia Computer Science,  
+ *    Volume 177, pp. 354-362, 2020
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#if defined(ESP32) || defined(WASM)
+#include <atomic>
+#endif
+
+//Bump-pointer blocks for the objects, which a chain configuration creates while being loaded.
+//The objects are allocated one after another, but they are freed together with the last of them,
+//which is typically once the configuration gets released - in a single call per block.
+//As the links and the parameters are reference counted, any of them can outlive the configuration;
+//therefore, every allocation holds a reference to the arena and the blocks go with the last one.
+class CConfiguration_Arena {
+protected:
+	struct TBlock {
+		TBlock* next;
+		size_t size;
+	};
+
+	static constexpr size_t Default_Block_Size = 4096;
+
+	TBlock* mBlocks = nullptr;
+	uint8_t* mCursor = nullptr;
+	uint8_t* mLimit = nullptr;
+
+#if (defined(ESP32) || defined(WASM)) && !defined(SCGMS_SINGLE_THREADED_REFCNT)
+	std::atomic<size_t> mReferences{ 1 };		//the owner and the live allocations
+#elif defined(FREERTOS) || defined(ESP32) || defined(WASM)
+	size_t mReferences = 1;
+#endif
+
+	CConfiguration_Arena() = default;
+	~CConfiguration_Arena();
+public:
+	static CConfiguration_Arena* Create() noexcept;	//the caller owns the first reference
+	void Add_Ref() noexcept;
+	void Release() noexcept;
+
+	void* Allocate(const size_t size) noexcept;		//aligned to max_align_t; nullptr if out of memory
+	size_t Reserved_Bytes() const noexcept;
+};
+
+//Makes the class' instances allocated from the arena, which is set for the current thread by CArena_Scope.
+//Without the scope, they go to the heap as usual.
+class CArena_Allocated {
+public:
+	static void* operator new(const size_t size) noexcept;
+	static void operator delete(void* ptr) noexcept;
+};
+
+class CArena_Scope {
+protected:
+	CConfiguration_Arena* mPrevious;
+public:
+	CArena_Scope(CConfiguration_Arena* arena) noexcept;
+	~CArena_Scope() noexcept;
+
+	CArena_Scope(const CArena_Scope&) = delete;
+	CArena_Scope& operator=(const CArena_Scope&) = delete;
+};
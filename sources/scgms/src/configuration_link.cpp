@@ -38,6 +38,9 @@
 
 #include <scgms/rtl/manufactory.h>
 
+#include <algorithm>
+#include <functional>
+
 CFilter_Configuration_Link::CFilter_Configuration_Link(const GUID &id) : mID(id) {
 //	mParent_Path = std::make_unique<std::wstring>();
 }
@@ -63,12 +66,87 @@ HRESULT IfaceCalling CFilter_Configuration_Link::Set_Variable(const wchar_t* nam
 
 }
 
+HRESULT IfaceCalling CFilter_Configuration_Link::QueryInterface(const GUID*  riid, void ** ppvObj) {
+	if (Internal_Query_Interface<scgms::IFilter_Configuration_Index>(scgms::IID_Filter_Configuration_Index, *riid, ppvObj)) return S_OK;
+
+	return E_NOINTERFACE;
+}
+
 HRESULT IfaceCalling CFilter_Configuration_Link::add(scgms::IFilter_Parameter** begin, scgms::IFilter_Parameter** end) {
+	mIndex_Valid = false;
 	HRESULT rc = refcnt::internal::CVector_Container<scgms::IFilter_Parameter*>::add(begin, end);
 
+	if (Succeeded(rc) && mVariable_Table) {
+		for (auto param = begin; param != end; param++) {
+			CFilter_Parameter* filter_parameter = dynamic_cast<CFilter_Parameter*>(*param);
+			if (filter_parameter)
+				filter_parameter->Bind_Variables(mVariable_Table);
+		}
+	}
+
 	return rc;
 }
 
+HRESULT IfaceCalling CFilter_Configuration_Link::remove(const size_t index) {
+	mIndex_Valid = false;
+	return refcnt::internal::CVector_Container<scgms::IFilter_Parameter*>::remove(index);
+}
+
+HRESULT IfaceCalling CFilter_Configuration_Link::move(const size_t from_index, const size_t to_index) {
+	mIndex_Valid = false;
+	return refcnt::internal::CVector_Container<scgms::IFilter_Parameter*>::move(from_index, to_index);
+}
+
+void CFilter_Configuration_Link::Index_Parameters() {
+	mIndex.clear();
+	mIndex.reserve(mData.size());
+
+	for (auto param : mData) {
+		wchar_t* config_name;
+		if ((param->Get_Config_Name(&config_name) == S_OK) && config_name)
+			mIndex.push_back({ intern_pool::Intern(config_name), param });	//CFilter_Parameter's names are interned already
+	}
+
+	//stable sort keeps the duplicated names in their order, so that the last one can be found - the one the linear scan has always resolved to
+	std::stable_sort(mIndex.begin(), mIndex.end(), [](const auto& a, const auto& b) {
+		return std::less<intern_pool::TString>{}(a.first, b.first);
+	});
+
+	mIndexed_Count = mData.size();
+	mIndex_Valid = true;
+}
+
+HRESULT IfaceCalling CFilter_Configuration_Link::Find_Parameter(const wchar_t* config_name, scgms::IFilter_Parameter** parameter) {
+	if (!config_name || !parameter) return E_INVALIDARG;
+
+	if (!mIndex_Valid || (mIndexed_Count != mData.size()))
+		Index_Parameters();
+
+	//a name that has never been interned cannot be configured
+	const intern_pool::TString name = intern_pool::Find(config_name);
+	auto iter = name ? std::upper_bound(mIndex.begin(), mIndex.end(), name, [](intern_pool::TString name, const auto& entry) {
+		return std::less<intern_pool::TString>{}(name, entry.first);
+	}) : mIndex.begin();
+
+	//the last of the equal names
+	if ((iter != mIndex.begin()) && (std::prev(iter)->first == name)) {
+		*parameter = std::prev(iter)->second;
+		return S_OK;
+	}
+
+	*parameter = nullptr;
+	return S_FALSE;
+}
+
+void CFilter_Configuration_Link::Bind_Variables(std::shared_ptr<CVariable_Table> table) {
+	mVariable_Table = std::move(table);
+	for (auto param : mData) {
+		CFilter_Parameter* filter_parameter = dynamic_cast<CFilter_Parameter*>(param);
+		if (filter_parameter)
+			filter_parameter->Bind_Variables(mVariable_Table);
+	}
+}
+
 HRESULT create_filter_configuration_link(const GUID* id, scgms::IFilter_Configuration_Link** link) {
 	return Manufacture_Object<CFilter_Configuration_Link>(link, *id);
 }
@@ -40,19 +40,37 @@
 #include <scgms/rtl/referencedImpl.h>
 
 #include "filter_parameter.h"
+#include "intern_pool.h"
+#include "configuration_arena.h"
 
 #pragma warning( push )
 #pragma warning( disable : 4250 ) // C4250 - 'class1' : inherits 'class2::member' via dominance 
 
-class CFilter_Configuration_Link : public virtual refcnt::internal::CVector_Container<scgms::IFilter_Parameter*>, public virtual scgms::IFilter_Configuration_Link {
+class CFilter_Configuration_Link : public virtual refcnt::internal::CVector_Container<scgms::IFilter_Parameter*>, public virtual scgms::IFilter_Configuration_Link, public virtual scgms::IFilter_Configuration_Index, public CArena_Allocated {
 protected:
 	const GUID mID;	
 	std::wstring mParent_Path;	//for resolving relative paths; see CPersistent_Chain_Configuration for unique_ptr exaplanation
+	std::shared_ptr<CVariable_Table> mVariable_Table;
+
+	//parameters sorted by their interned config names, so that the lookup compares pointers only
+	//invalidated by any modification of the container; pop is final, hence the size is checked as well
+	std::vector<std::pair<intern_pool::TString, scgms::IFilter_Parameter*>> mIndex;
+	bool mIndex_Valid = false;
+	size_t mIndexed_Count = 0;
 public:
 	CFilter_Configuration_Link(const GUID &id);
 	virtual ~CFilter_Configuration_Link() = default;
 
+	void Bind_Variables(std::shared_ptr<CVariable_Table> table);	//the parameters evaluate the chain's variables from the table
+	void Index_Parameters();	//called once the link is complete, so that the filters do not scan all the parameters on every read
+
+	virtual HRESULT IfaceCalling QueryInterface(const GUID*  riid, void ** ppvObj) override;
+
 	virtual HRESULT IfaceCalling add(scgms::IFilter_Parameter* *begin, scgms::IFilter_Parameter* *end) override;
+	virtual HRESULT IfaceCalling remove(const size_t index) override;
+	virtual HRESULT IfaceCalling move(const size_t from_index, const size_t to_index) override;
+
+	virtual HRESULT IfaceCalling Find_Parameter(const wchar_t* config_name, scgms::IFilter_Parameter** parameter) override final;
 
 	virtual HRESULT IfaceCalling Get_Filter_Id(GUID *id) override final;
 	virtual HRESULT IfaceCalling Set_Variable(const wchar_t* name, const wchar_t* value) override final;
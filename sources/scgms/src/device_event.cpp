@@ -40,6 +40,7 @@
 #include <scgms/rtl/manufactory.h>
 #include <scgms/rtl/referencedImpl.h>
 #include <scgms/rtl/DeviceLib.h>
+#include <scgms/utils/heap_profiler.h>
 
 #include <atomic>
 #include <stdexcept>
@@ -224,6 +225,7 @@ HRESULT IfaceCalling CDevice_Event::Raw(scgms::TDevice_Event **dst) noexcept {
 
 HRESULT IfaceCalling CDevice_Event::Clone(IDevice_Event** event) const noexcept {
 
+	SCGMS_HEAP_TAG(Events);
 	auto clone = event_pool.Alloc_Event();
 	if (clone) {
 		Clone_Raw(mRaw, clone->mRaw);
@@ -235,6 +237,7 @@ HRESULT IfaceCalling CDevice_Event::Clone(IDevice_Event** event) const noexcept
 
 //syntactic sugar 
 scgms::IDevice_Event* allocate_device_event(scgms::NDevice_Event_Code code) noexcept {
+	SCGMS_HEAP_TAG(Events);
 	auto result = event_pool.Alloc_Event();
 	if (result)
 		result->Initialize(code);
@@ -0,0 +1,189 @@
+/**
+ * SmartCGMS - continuous glucose monitoring and controlling framework
+ * https://diabetes.zcu.cz/
+ *
+ * Copyright (c) since 2018 University of West Bohemia.
+ *
+ * Contact:
+ * diabetes@mail.kiv.zcu.cz
+ * Medical Informatics, Department of Computer Science and Engineering
+ * Faculty of Applied Sciences, University of West Bohemia
+ * Univerzitni 8, 301 00 Pilsen
+ * Czech Republic
+ * 
+ * 
+ * Purpose of this software:
+ * This software is intended to demonstrate work of the diabetes.zcu.cz research
+ * group to other scientists, to complement our published papers. It is strictly
+ * prohibited to use this software for diagnosis or treatment of any medical condition,
+ * without obtaining all required approvals from respective regulatory bodies.
+ *
+ * Especially, a diabetic patient is warned that unauthorized use of this software
+ * may result into severe injure, including death.
+ *
+ *
+ * Licensing terms:
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * a) This file is available under the Apache License, Version 2.0.
+ * b) When publishing any derivative work or results obtained using this software, you agree to cite the following paper:
+ *    Tomas Koutny and Martin Ubl, "SmartCGMS as a Testbed for a Blood-Glucose Level Prediction and/or 
+ *    Control Challenge with (an FDA-Accepted) Diabetic Patient Simulation", Procedia Computer Science,  
+ *    Volume 177, pp. 354-362, 2020
+ */
+
+#include "event_store.h"
+
+#include <scgms/rtl/DeviceLib.h>
+
+#include <algorithm>
+
+CColumnar_Event_Store::CColumnar_Event_Store(const size_t expected_events, const size_t expected_parameters, const size_t expected_info_chars) {
+	Reserve(expected_events, expected_parameters, expected_info_chars);
+}
+
+void CColumnar_Event_Store::Reserve(const size_t expected_events, const size_t expected_parameters, const size_t expected_info_chars) {
+	mEvent_Code.reserve(expected_events);
+	mDevice_Handle.reserve(expected_events);
+	mSignal_Handle.reserve(expected_events);
+	mDevice_Time.reserve(expected_events);
+	mSegment_Id.reserve(expected_events);
+	mLevel.reserve(expected_events);
+
+	mParameters_Pool.reserve(expected_parameters);
+	mInfo_Pool.reserve(expected_info_chars);
+}
+
+void CColumnar_Event_Store::Clear() noexcept {
+	//clear keeps the capacity, so that the store can be reused without reallocations
+	mEvent_Code.clear();
+	mDevice_Handle.clear();
+	mSignal_Handle.clear();
+	mDevice_Time.clear();
+	mSegment_Id.clear();
+	mLevel.clear();
+
+	mPayloads.clear();
+	mParameters_Pool.clear();
+	mInfo_Pool.clear();
+}
+
+CColumnar_Event_Store::THandle CColumnar_Event_Store::Intern(const GUID &id) {
+	//there are just a few distinct ids in a chain and consecutive events tend to share them
+	if ((mLast_Interned != Invalid_Handle) && (mInterned_Ids[mLast_Interned] == id))
+		return mLast_Interned;
+
+	const auto iter = std::find(mInterned_Ids.begin(), mInterned_Ids.end(), id);
+	if (iter != mInterned_Ids.end())
+		mLast_Interned = static_cast<THandle>(std::distance(mInterned_Ids.begin(), iter));
+	else {
+		mLast_Interned = static_cast<THandle>(mInterned_Ids.size());
+		mInterned_Ids.push_back(id);
+	}
+
+	return mLast_Interned;
+}
+
+HRESULT CColumnar_Event_Store::Push(const scgms::TDevice_Event &event) noexcept {
+	const size_t event_index = mEvent_Code.size();
+	const size_t payloads_count = mPayloads.size();
+	const size_t parameters_count = mParameters_Pool.size();
+	const size_t info_count = mInfo_Pool.size();
+
+	try {
+		mEvent_Code.push_back(event.event_code);
+		mDevice_Handle.push_back(Intern(event.device_id));
+		mSignal_Handle.push_back(Intern(event.signal_id));
+		mDevice_Time.push_back(event.device_time);
+		mSegment_Id.push_back(event.segment_id);
+
+		double level = std::numeric_limits<double>::quiet_NaN();
+
+		switch (scgms::UDevice_Event_internal::major_type(event.event_code)) {
+			case scgms::UDevice_Event_internal::NDevice_Event_Major_Type::level:
+				level = event.level;
+				break;
+
+			case scgms::UDevice_Event_internal::NDevice_Event_Major_Type::parameters:
+				if (event.parameters) {
+					double *begin, *end;
+					if (event.parameters->get(&begin, &end) == S_OK) {
+						mPayloads.push_back(TPayload_Reference{ event_index, mParameters_Pool.size(), static_cast<size_t>(std::distance(begin, end)) });
+						mParameters_Pool.insert(mParameters_Pool.end(), begin, end);
+					}
+				}
+				break;
+
+			case scgms::UDevice_Event_internal::NDevice_Event_Major_Type::info:
+				if (event.info) {
+					wchar_t *begin, *end;
+					if (event.info->get(&begin, &end) == S_OK) {
+						mPayloads.push_back(TPayload_Reference{ event_index, mInfo_Pool.size(), static_cast<size_t>(std::distance(begin, end)) });
+						mInfo_Pool.insert(mInfo_Pool.end(), begin, end);
+						mInfo_Pool.push_back(L'\0');
+					}
+				}
+				break;
+
+			default:
+				break;
+		}
+
+		mLevel.push_back(level);
+	}
+	catch (...) {
+		//roll back the partially appended row, so that the columns stay aligned
+		mEvent_Code.resize(event_index);
+		mDevice_Handle.resize(event_index);
+		mSignal_Handle.resize(event_index);
+		mDevice_Time.resize(event_index);
+		mSegment_Id.resize(event_index);
+		mLevel.resize(event_index);
+
+		mPayloads.resize(payloads_count);
+		mParameters_Pool.resize(parameters_count);
+		mInfo_Pool.resize(info_count);
+		return E_OUTOFMEMORY;
+	}
+
+	return S_OK;
+}
+
+GUID CColumnar_Event_Store::Id(const THandle handle) const noexcept {
+	return handle < mInterned_Ids.size() ? mInterned_Ids[handle] : Invalid_GUID;
+}
+
+CColumnar_Event_Store::THandle CColumnar_Event_Store::Handle(const GUID &id) const noexcept {
+	const auto iter = std::find(mInterned_Ids.begin(), mInterned_Ids.end(), id);
+	return iter != mInterned_Ids.end() ? static_cast<THandle>(std::distance(mInterned_Ids.begin(), iter)) : Invalid_Handle;
+}
+
+const CColumnar_Event_Store::TPayload_Reference* CColumnar_Event_Store::Find_Payload(const size_t event_index) const noexcept {
+	const auto iter = std::lower_bound(mPayloads.begin(), mPayloads.end(), event_index, [](const TPayload_Reference &payload, const size_t index) {
+		return payload.event_index < index;
+	});
+
+	return ((iter != mPayloads.end()) && (iter->event_index == event_index)) ? &(*iter) : nullptr;
+}
+
+TColumn_Span<double> CColumnar_Event_Store::Parameters(const size_t event_index) const noexcept {
+	if ((event_index >= mEvent_Code.size()) || (scgms::UDevice_Event_internal::major_type(mEvent_Code[event_index]) != scgms::UDevice_Event_internal::NDevice_Event_Major_Type::parameters))
+		return {};
+
+	const TPayload_Reference *payload = Find_Payload(event_index);
+	if (!payload)
+		return {};
+
+	const double *first = mParameters_Pool.data() + payload->offset;
+	return { first, first + payload->count };
+}
+
+const wchar_t* CColumnar_Event_Store::Info(const size_t event_index) const noexcept {
+	if ((event_index >= mEvent_Code.size()) || (scgms::UDevice_Event_internal::major_type(mEvent_Code[event_index]) != scgms::UDevice_Event_internal::NDevice_Event_Major_Type::info))
+		return nullptr;
+
+	const TPayload_Reference *payload = Find_Payload(event_index);
+	return payload ? mInfo_Pool.data() + payload->offset : nullptr;
+}
@@ -0,0 +1,110 @@
+/**
+ * SmartCGMS - continuous glucose monitoring and controlling framework
+ * https://diabetes.zcu.cz/
+ *
+ * Copyright (c) since 2018 University of West Bohemia.
+ *
+ * Contact:
+ * diabetes@mail.kiv.zcu.cz
+ * Medical Informatics, Department of Computer Science and Engineering
+ * Faculty of Applied Sciences, University of West Bohemia
+ * Univerzitni 8, 301 00 Pilsen
+ * Czech Republic
+ * 
+ * 
+ * Purpose of this software:
+ * This software is intended to demonstrate work of the diabetes.zcu.cz research
+ * group to other scientists, to complement our published papers. It is strictly
+ * prohibited to use this software for diagnosis or treatment of any medical condition,
+ * without obtaining all required approvals from respective regulatory bodies.
+ *
+ * Especially, a diabetic patient is warned that unauthorized use of this software
+ * may result into severe injure, including death.
+ *
+ *
+ * Licensing terms:
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * a) This file is available under the Apache License, Version 2.0.
+ * b) When publishing any derivative work or results obtained using this software, you agree to cite the following paper:
+ *    Tomas Koutny and Martin Ubl, "SmartCGMS as a Testbed for a Blood-Glucose Level Prediction and/or 
+ *    Control Challenge with (an FDA-Accepted) Diabetic Patient Simulation", Procedia Computer Science,  
+ *    Volume 177, pp. 354-362, 2020
+ */
+
+#pragma once
+
+#include <scgms/iface/DeviceIface.h>
+
+#include <vector>
+#include <limits>
+
+//read-only, non-owning view of a contiguous column; valid until the store is modified
+template <typename T>
+struct TColumn_Span {
+	const T *first = nullptr;
+	const T *last = nullptr;
+
+	const T* begin() const noexcept { return first; }
+	const T* end() const noexcept { return last; }
+	size_t size() const noexcept { return static_cast<size_t>(last - first); }
+	bool empty() const noexcept { return first == last; }
+	const T& operator[](const size_t index) const noexcept { return first[index]; }
+};
+
+//Structure-of-arrays store of the events collected by CCopying_Terminal_Filter.
+//Each event occupies one row in every column; GUIDs are interned to small handles
+//and the parameters/info payloads are appended to shared pools instead of being
+//kept as separately allocated, refcounted containers.
+class CColumnar_Event_Store {
+public:
+	using THandle = uint32_t;
+	static constexpr THandle Invalid_Handle = std::numeric_limits<THandle>::max();
+protected:
+	struct TPayload_Reference {
+		size_t event_index;
+		size_t offset;		//into the parameters or info pool, according to the event code
+		size_t count;		//for info, excluding the terminating zero
+	};
+protected:
+	std::vector<scgms::NDevice_Event_Code> mEvent_Code;
+	std::vector<THandle> mDevice_Handle;
+	std::vector<THandle> mSignal_Handle;
+	std::vector<double> mDevice_Time;
+	std::vector<uint64_t> mSegment_Id;
+	std::vector<double> mLevel;		//NaN for the non-level events
+
+	std::vector<GUID> mInterned_Ids;
+	THandle mLast_Interned = Invalid_Handle;
+
+	std::vector<TPayload_Reference> mPayloads;		//sorted by event_index, as the events are appended only
+	std::vector<double> mParameters_Pool;
+	std::vector<wchar_t> mInfo_Pool;
+
+	THandle Intern(const GUID &id);
+	const TPayload_Reference* Find_Payload(const size_t event_index) const noexcept;
+public:
+	CColumnar_Event_Store(const size_t expected_events = 0, const size_t expected_parameters = 0, const size_t expected_info_chars = 0);
+
+	void Reserve(const size_t expected_events, const size_t expected_parameters = 0, const size_t expected_info_chars = 0);
+	void Clear() noexcept;
+
+	HRESULT Push(const scgms::TDevice_Event &event) noexcept;		//on failure, the store is left as it was
+	size_t size() const noexcept { return mEvent_Code.size(); }
+
+	TColumn_Span<scgms::NDevice_Event_Code> Event_Codes() const noexcept { return { mEvent_Code.data(), mEvent_Code.data() + mEvent_Code.size() }; }
+	TColumn_Span<THandle> Device_Handles() const noexcept { return { mDevice_Handle.data(), mDevice_Handle.data() + mDevice_Handle.size() }; }
+	TColumn_Span<THandle> Signal_Handles() const noexcept { return { mSignal_Handle.data(), mSignal_Handle.data() + mSignal_Handle.size() }; }
+	TColumn_Span<double> Device_Times() const noexcept { return { mDevice_Time.data(), mDevice_Time.data() + mDevice_Time.size() }; }
+	TColumn_Span<uint64_t> Segment_Ids() const noexcept { return { mSegment_Id.data(), mSegment_Id.data() + mSegment_Id.size() }; }
+	TColumn_Span<double> Levels() const noexcept { return { mLevel.data(), mLevel.data() + mLevel.size() }; }
+
+	//handles are shared by device and signal ids
+	GUID Id(const THandle handle) const noexcept;
+	THandle Handle(const GUID &id) const noexcept;	//returns Invalid_Handle if the id has not been stored
+
+	TColumn_Span<double> Parameters(const size_t event_index) const noexcept;	//empty span for events without parameters
+	const wchar_t* Info(const size_t event_index) const noexcept;				//nullptr for events without info
+};
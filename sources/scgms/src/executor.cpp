@@ -41,25 +41,53 @@
 #include "filters.h"
 #endif
 #include "device_event.h"
+#include "startup_profiler.h"
 
 #if defined(FREERTOS) || defined (WASM)
-CFilter_Executor::CFilter_Executor(const GUID filter_id, scgms::IFilter *next_filter, scgms::TOn_Filter_Created on_filter_created, const void* on_filter_created_data) :
-	mOn_Filter_Created(on_filter_created), mOn_Filter_Created_Data(on_filter_created_data) {
+CFilter_Executor::CFilter_Executor(const GUID filter_id, CFeedback_Channels &feedback_channels, scgms::IFilter *next_filter, scgms::TOn_Filter_Created on_filter_created, const void* on_filter_created_data) :
+	mFeedback_Channels(feedback_channels), mFilter_Id(filter_id), mOn_Filter_Created(on_filter_created), mOn_Filter_Created_Data(on_filter_created_data) {
 	
-	mFilter = create_filter_body(filter_id, next_filter);
+	Create_Filter(filter_id, next_filter);
 }
 #elif defined (ESP32)
-CFilter_Executor::CFilter_Executor(const GUID filter_id, std::recursive_mutex &communication_guard, scgms::IFilter *next_filter, scgms::TOn_Filter_Created on_filter_created, const void* on_filter_created_data) :
-	mCommunication_Guard(communication_guard),  mOn_Filter_Created(on_filter_created), mOn_Filter_Created_Data(on_filter_created_data) {
+CFilter_Executor::CFilter_Executor(const GUID filter_id, std::recursive_mutex &communication_guard, CFeedback_Channels &feedback_channels, scgms::IFilter *next_filter, scgms::TOn_Filter_Created on_filter_created, const void* on_filter_created_data) :
+	mCommunication_Guard(communication_guard), mFeedback_Channels(feedback_channels), mFilter_Id(filter_id), mOn_Filter_Created(on_filter_created), mOn_Filter_Created_Data(on_filter_created_data) {
 	
-	mFilter = create_filter_body(filter_id, next_filter);
+	Create_Filter(filter_id, next_filter);
 }
 #endif
 
+void CFilter_Executor::Create_Filter(const GUID &filter_id, scgms::IFilter *next_filter) {
+	SCGMS_STARTUP_PHASE(Filter_Construction, filter_id);
+	mFilter_Id = filter_id;
+	if (!Is_Invalid_GUID(filter_id))
+		mFilter = create_filter_body(filter_id, next_filter);
+}
+
+HRESULT CFilter_Executor::Filter_Created() {
+	//at this point, we will call a callback function to perform any additional configuration of the filter we've just configured 
+	return mOn_Filter_Created ? mOn_Filter_Created(mFilter.get(), mOn_Filter_Created_Data) : S_OK;
+}
+
 void CFilter_Executor::Release_Filter() {
 	if (mFilter) mFilter.reset();
 }
 
+void CFilter_Executor::Take_Filter(CFilter_Executor &other) {
+	Release_Filter();
+	mFilter = other.mFilter;
+	other.Release_Filter();
+	mFilter_Id = other.mFilter_Id;
+	mConfiguration_Hash = other.mConfiguration_Hash;
+
+	other.mFilter_Id = Invalid_GUID;
+	other.mConfiguration_Hash = 0;
+}
+
+HRESULT CFilter_Executor::Reconfigure(scgms::IFilter_Configuration* configuration, refcnt::wstr_list *error_description) {
+	return mFilter ? mFilter->Configure(configuration, error_description) : E_FAIL;
+}
+
 
 HRESULT IfaceCalling CFilter_Executor::Configure(scgms::IFilter_Configuration* configuration, refcnt::wstr_list* error_description) {
 
@@ -67,10 +95,8 @@ HRESULT IfaceCalling CFilter_Executor::Configure(scgms::IFilter_Configuration* c
 		return E_FAIL;
 
 	HRESULT rc = mFilter->Configure(configuration, error_description);
-	if ((rc == S_OK) && mOn_Filter_Created) {
-		//at this point, we will call a callback function to perform any additional configuration of the filter we've just configured 
-		rc = mOn_Filter_Created(mFilter.get(), mOn_Filter_Created_Data);
-	}
+	if (rc == S_OK)
+		rc = Filter_Created();
 
 	return rc;
 }
@@ -80,7 +106,17 @@ HRESULT IfaceCalling CFilter_Executor::Execute(scgms::IDevice_Event *event) {
 	//Simply acquire the lock and then call execute method of the filter
 	std::lock_guard<std::recursive_mutex> guard{ mCommunication_Guard };
 #endif
-	return mFilter->Execute(event);
+	if (!mFilter) {
+		//a reconfiguration's placeholder, which has not got its filter yet
+		event->Release();
+		return S_FALSE;
+	}
+
+	mFeedback_Channels.Enter();
+	const HRESULT rc = mFilter->Execute(event);
+	mFeedback_Channels.Leave();	//delivers the queued feedback, once the outermost execute completes
+
+	return rc;
 }
 
 
@@ -129,7 +165,26 @@ HRESULT IfaceCalling CTerminal_Filter::Execute(scgms::IDevice_Event *event) {
 };
 
 
-CCopying_Terminal_Filter::CCopying_Terminal_Filter(std::vector<CDevice_Event> &events, bool do_not_copy_info_events) : CTerminal_Filter(nullptr), mEvents(events), mDo_Not_Copy_Info_Events(do_not_copy_info_events) {
+CChain_Output::CChain_Output(scgms::IFilter *next_filter) : mNext_Filter(next_filter) {
+}
+
+HRESULT IfaceCalling CChain_Output::Configure(scgms::IFilter_Configuration* configuration, refcnt::wstr_list* error_description) {
+	return S_OK;
+}
+
+HRESULT IfaceCalling CChain_Output::Execute(scgms::IDevice_Event *event) {
+	if (!event) return E_INVALIDARG;
+
+	if (!mOpen) {
+		event->Release();
+		return S_FALSE;
+	}
+
+	return mNext_Filter->Execute(event);
+}
+
+
+CCopying_Terminal_Filter::CCopying_Terminal_Filter(CColumnar_Event_Store &events, bool do_not_copy_info_events) : CTerminal_Filter(nullptr), mEvents(events), mDo_Not_Copy_Info_Events(do_not_copy_info_events) {
 
 }
 
@@ -142,12 +197,11 @@ HRESULT IfaceCalling CCopying_Terminal_Filter::Execute(scgms::IDevice_Event *eve
 		if (mDo_Not_Copy_Info_Events && (scgms::UDevice_Event_internal::major_type(raw_event->event_code) == scgms::UDevice_Event_internal::NDevice_Event_Major_Type::info)) {
 			return CTerminal_Filter::Execute(event);
 		} else {
-			CDevice_Event clone;
-			clone.Initialize(raw_event);		
-
-
-			mEvents.push_back(std::move(clone));
-			return CTerminal_Filter::Execute(event);
+			//copy just the values into the columns, the event itself is released as usual
+			//even if the copy fails, but the caller has to learn that the store misses it
+			const HRESULT push_rc = mEvents.Push(*raw_event);
+			const HRESULT terminal_rc = CTerminal_Filter::Execute(event);
+			return Succeeded(push_rc) ? terminal_rc : push_rc;
 		}
 	}
 	else
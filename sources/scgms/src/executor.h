@@ -39,6 +39,10 @@
 #include <scgms/rtl/FilterLib.h>
 
 #include "device_event.h"
+#include "event_store.h"
+#include "feedback_queue.h"
+
+#include <atomic>
 
 #if defined(ESP32)
 #include <mutex>
@@ -54,19 +58,33 @@ protected:
 #if defined(ESP32)
 	std::recursive_mutex &mCommunication_Guard;
 #endif
+	CFeedback_Channels &mFeedback_Channels;
+	GUID mFilter_Id;
 	scgms::SFilter mFilter;
 	scgms::TOn_Filter_Created mOn_Filter_Created;
 	const void* mOn_Filter_Created_Data;
+	uint64_t mConfiguration_Hash = 0;	//of the configuration the filter runs with
 public:
 #if defined(ESP32)
-	CFilter_Executor(const GUID filter_id, std::recursive_mutex &communication_guard, scgms::IFilter *next_filter, scgms::TOn_Filter_Created on_filter_created, const void* on_filter_created_data);
+	CFilter_Executor(const GUID filter_id, std::recursive_mutex &communication_guard, CFeedback_Channels &feedback_channels, scgms::IFilter *next_filter, scgms::TOn_Filter_Created on_filter_created, const void* on_filter_created_data);
 #elif defined(FREERTOS) || defined(WASM)
-	CFilter_Executor(const GUID filter_id, scgms::IFilter *next_filter, scgms::TOn_Filter_Created on_filter_created, const void* on_filter_created_data);
+	CFilter_Executor(const GUID filter_id, CFeedback_Channels &feedback_channels, scgms::IFilter *next_filter, scgms::TOn_Filter_Created on_filter_created, const void* on_filter_created_data);
 #endif
 	virtual ~CFilter_Executor() = default;
 
 	void Release_Filter();
 
+	//live reconfiguration support; Invalid_GUID as the constructor's filter_id creates an executor without a filter
+	const GUID& Filter_Id() const noexcept { return mFilter_Id; }
+	uint64_t Configuration_Hash() const noexcept { return mConfiguration_Hash; }
+	void Set_Configuration_Hash(const uint64_t hash) noexcept { mConfiguration_Hash = hash; }
+	void Take_Filter(CFilter_Executor &other);		//releases this filter and moves the other's one here, so that the filters pointing to this executor get the other filter
+	HRESULT Reconfigure(scgms::IFilter_Configuration* configuration, refcnt::wstr_list *error_description);	//Configure, without calling on_filter_created again
+
+	//parallel build support - the executors are allocated first, so that the filters can be created in any order
+	void Create_Filter(const GUID &filter_id, scgms::IFilter *next_filter);	//into an executor created without a filter
+	HRESULT Filter_Created();		//calls on_filter_created, if there is any
+
 	virtual HRESULT IfaceCalling QueryInterface(const GUID*  riid, void ** ppvObj) override;
 
 	virtual HRESULT IfaceCalling Configure(scgms::IFilter_Configuration* configuration, refcnt::wstr_list *error_description) override final;
@@ -92,12 +110,27 @@ public:
 	virtual HRESULT IfaceCalling Execute(scgms::IDevice_Event *event) override;
 };
 
+class CChain_Output : public virtual scgms::IFilter, public virtual refcnt::CNotReferenced {
+	//the chain's next filter for the last filter created by a reconfiguration - closed until the filter makes it into the chain
+protected:
+	scgms::IFilter *mNext_Filter;
+	std::atomic<bool> mOpen{ false };
+public:
+	CChain_Output(scgms::IFilter *next_filter);
+	virtual ~CChain_Output() = default;
+
+	void Open() noexcept { mOpen = true; }
+
+	virtual HRESULT IfaceCalling Configure(scgms::IFilter_Configuration* configuration, refcnt::wstr_list* error_description) override final;
+	virtual HRESULT IfaceCalling Execute(scgms::IDevice_Event *event) override final;
+};
+
 class CCopying_Terminal_Filter : public virtual CTerminal_Filter {
 protected:
-	std::vector<CDevice_Event> &mEvents;
+	CColumnar_Event_Store &mEvents;
 	bool mDo_Not_Copy_Info_Events = true;
 public:
-	CCopying_Terminal_Filter(std::vector<CDevice_Event> &events, bool do_not_copy_info_events);
+	CCopying_Terminal_Filter(CColumnar_Event_Store &events, bool do_not_copy_info_events);
 	virtual ~CCopying_Terminal_Filter() = default;
 	virtual HRESULT IfaceCalling Execute(scgms::IDevice_Event *event) override final;
 };
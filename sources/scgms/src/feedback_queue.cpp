@@ -0,0 +1,289 @@
+/**
+ * SmartCGMS - continuous glucose monitoring and controlling framework
+ * https://diabetes.zcu.cz/
+ *
+ * Copyright (c) since 2018 University of West Bohemia.
+ *
+ * Contact:
+ * diabetes@mail.kiv.zcu.cz
+ * Medical Informatics, Department of Computer Science and Engineering
+ * Faculty of Applied Sciences, University of West Bohemia
+ * Univerzitni 8, 301 00 Pilsen
+ * Czech Republic
+ * 
+ * 
+ * Purpose of this software:
+ * This software is intended to demonstrate work of the diabetes.zcu.cz research
+ * group to other scientists, to complement our published papers. It is strictly
+ * prohibited to use this software for diagnosis or treatment of any medical condition,
+ * without obtaining all required approvals from respective regulatory bodies.
+ *
+ * Especially, a diabetic patient is warned that unauthorized use of this software
+ * may result into severe injure, including death.
+ *
+ *
+ * Licensing terms:
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * a) This file is available under the Apache License, Version 2.0.
+ * b) When publishing any derivative work or results obtained using this software, you agree to cite the following paper:
+ *    Tomas Koutny and Martin Ubl, "SmartCGMS as a Testbed for a Blood-Glucose Level Prediction and/or 
+ *    Control Challenge with (an FDA-Accepted) Diabetic Patient Simulation", Procedia Computer Science,  
+ *    Volume 177, pp. 354-362, 2020
+ */
+
+#include "feedback_queue.h"
+
+CBounded_Event_Queue::CBounded_Event_Queue() noexcept {
+	for (size_t i = 0; i < Capacity; i++) {
+		mCells[i].sequence = i;
+		mCells[i].event = nullptr;
+	}
+}
+
+#if defined(ESP32) || defined(WASM)
+
+bool CBounded_Event_Queue::Push(scgms::IDevice_Event *event) noexcept {
+	size_t position = mEnqueue_Position.load(std::memory_order_relaxed);
+	TCell *cell;
+
+	while (true) {
+		cell = &mCells[position & Mask];
+		const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+		const intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+
+		if (difference == 0) {
+			if (mEnqueue_Position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+				break;
+		}
+		else if (difference < 0)
+			return false;	//full
+		else
+			position = mEnqueue_Position.load(std::memory_order_relaxed);
+	}
+
+	cell->event = event;
+	cell->sequence.store(position + 1, std::memory_order_release);
+	return true;
+}
+
+bool CBounded_Event_Queue::Pop(scgms::IDevice_Event **event) noexcept {
+	size_t position = mDequeue_Position.load(std::memory_order_relaxed);
+	TCell *cell;
+
+	while (true) {
+		cell = &mCells[position & Mask];
+		const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+		const intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position + 1);
+
+		if (difference == 0) {
+			if (mDequeue_Position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+				break;
+		}
+		else if (difference < 0)
+			return false;	//empty
+		else
+			position = mDequeue_Position.load(std::memory_order_relaxed);
+	}
+
+	*event = cell->event;
+	cell->event = nullptr;
+	cell->sequence.store(position + Mask + 1, std::memory_order_release);
+	return true;
+}
+
+#elif defined(FREERTOS)
+
+bool CBounded_Event_Queue::Push(scgms::IDevice_Event *event) noexcept {
+	TCell &cell = mCells[mEnqueue_Position & Mask];
+	if (cell.sequence != mEnqueue_Position)
+		return false;	//full
+
+	cell.event = event;
+	cell.sequence = mEnqueue_Position + 1;
+	mEnqueue_Position++;
+	return true;
+}
+
+bool CBounded_Event_Queue::Pop(scgms::IDevice_Event **event) noexcept {
+	TCell &cell = mCells[mDequeue_Position & Mask];
+	if (cell.sequence != mDequeue_Position + 1)
+		return false;	//empty
+
+	*event = cell.event;
+	cell.event = nullptr;
+	cell.sequence = mDequeue_Position + Mask + 1;
+	mDequeue_Position++;
+	return true;
+}
+
+#endif
+
+
+CFeedback_Queue::CFeedback_Queue(scgms::IFilter_Feedback_Receiver *receiver, CFeedback_Channels &channels) noexcept : mReceiver(receiver), mChannels(channels) {
+	//
+}
+
+CFeedback_Queue::~CFeedback_Queue() {
+	Close();
+}
+
+bool CFeedback_Queue::Drain() noexcept {
+	bool delivered = false;
+
+	scgms::IDevice_Event *event;
+	while (!mClosed && mQueue.Pop(&event)) {
+		mReceiver->Execute(event);
+		delivered = true;
+	}
+
+	//the overflow is younger than anything the ring has held meanwhile
+	if (mOverflowed)
+		delivered |= Drain_Overflow();
+
+	return delivered;
+}
+
+bool CFeedback_Queue::Overflow(scgms::IDevice_Event *event) noexcept {
+#if defined(ESP32)
+	std::lock_guard<std::mutex> guard{ mOverflow_Guard };
+#endif
+	try {
+		mOverflow.push_back(event);
+	}
+	catch (...) {
+		return false;
+	}
+
+	mOverflowed = true;
+	return true;
+}
+
+bool CFeedback_Queue::Drain_Overflow() noexcept {
+	std::vector<scgms::IDevice_Event*> pending;
+	{
+#if defined(ESP32)
+		std::lock_guard<std::mutex> guard{ mOverflow_Guard };
+#endif
+		pending.swap(mOverflow);
+		mOverflowed = false;	//what the receivers send meanwhile goes to the ring again, i.e.; after the pending events
+	}
+
+	for (auto event : pending) {
+		if (mClosed)
+			event->Release();
+		else
+			mReceiver->Execute(event);
+	}
+
+	return !pending.empty();
+}
+
+void CFeedback_Queue::Close() noexcept {
+	mClosed = true;
+
+	//whatever has not been delivered, has to be released
+	scgms::IDevice_Event *event;
+	while (mQueue.Pop(&event))
+		event->Release();
+
+#if defined(ESP32)
+	std::lock_guard<std::mutex> guard{ mOverflow_Guard };
+#endif
+	for (auto overflown : mOverflow)
+		overflown->Release();
+	mOverflow.clear();
+	mOverflowed = false;
+}
+
+HRESULT IfaceCalling CFeedback_Queue::Name(wchar_t** const name) {
+	return mReceiver->Name(name);
+}
+
+HRESULT IfaceCalling CFeedback_Queue::Configure(scgms::IFilter_Configuration* configuration, refcnt::wstr_list *error_description) {
+	return E_ILLEGAL_METHOD_CALL;	//the receiver has been configured already
+}
+
+HRESULT IfaceCalling CFeedback_Queue::Execute(scgms::IDevice_Event *event) {
+	if (!event) return E_INVALIDARG;
+
+	if (mClosed) {
+		event->Release();
+		return E_ILLEGAL_METHOD_CALL;
+	}
+
+	//not sent from within the chain, so that there is no execute to complete - the receiver gets it right away
+	if (!mChannels.Executing())
+		return mReceiver->Execute(event);
+
+	//once overflown, the ring may take the events again only after the older ones have been delivered
+	if (mOverflowed || !mQueue.Push(event)) {
+		if (!Overflow(event)) {
+			event->Release();
+			return E_OUTOFMEMORY;
+		}
+	}
+
+	return S_OK;
+}
+
+
+CFeedback_Queue* CFeedback_Channels::Add_Receiver(scgms::IFilter_Feedback_Receiver *receiver) {
+	std::unique_ptr<CFeedback_Queue> queue = std::make_unique<CFeedback_Queue>(receiver, *this);
+	CFeedback_Queue *result = queue.get();
+	mQueues.push_back(std::move(queue));
+	return result;
+}
+
+void CFeedback_Channels::Close() noexcept {
+	for (auto &queue : mQueues)
+		queue->Close();
+}
+
+void CFeedback_Channels::Clear() noexcept {
+	mQueues.clear();
+	mExecute_Depth = 0;
+#if defined(ESP32)
+	mExecuting_Thread = std::thread::id{};
+#endif
+}
+
+void CFeedback_Channels::Enter() noexcept {
+#if defined(ESP32)
+	if (mExecute_Depth == 0)
+		mExecuting_Thread = std::this_thread::get_id();
+#endif
+	mExecute_Depth++;
+}
+
+void CFeedback_Channels::Leave() noexcept {
+	if (mExecute_Depth > 1) {
+		mExecute_Depth--;
+		return;
+	}
+
+	//we are leaving the outermost execute => deliver the feedback, while still counting as nested,
+	//so that the receivers' executes do not drain on their own; repeat until feedback stops producing feedback
+	bool delivered;
+	do {
+		delivered = false;
+		for (auto &queue : mQueues)
+			delivered |= queue->Drain();
+	} while (delivered);
+
+	mExecute_Depth = 0;
+#if defined(ESP32)
+	mExecuting_Thread = std::thread::id{};
+#endif
+}
+
+bool CFeedback_Channels::Executing() const noexcept {
+#if defined(ESP32)
+	//the depth is guarded by the communication guard, which the calling thread need not hold
+	return mExecuting_Thread == std::this_thread::get_id();
+#elif defined(FREERTOS) || defined(WASM)
+	return mExecute_Depth > 0;
+#endif
+}
@@ -0,0 +1,145 @@
+/**
+ * SmartCGMS - continuous glucose monitoring and controlling framework
+ * https://diabetes.zcu.cz/
+ *
+ * Copyright (c) since 2018 University of West Bohemia.
+ *
+ * Contact:
+ * diabetes@mail.kiv.zcu.cz
+ * Medical Informatics, Department of Computer Science and Engineering
+ * Faculty of Applied Sciences, University of West Bohemia
+ * Univerzitni 8, 301 00 Pilsen
+ * Czech Republic
+ * 
+ * 
+ * Purpose of this software:
+ * This software is intended to demonstrate work of the diabetes.zcu.cz research
+ * group to other scientists, to complement our published papers. It is strictly
+ * prohibited to use this software for diagnosis or treatment of any medical condition,
+ * without obtaining all required approvals from respective regulatory bodies.
+ *
+ * Especially, a diabetic patient is warned that unauthorized use of this software
+ * may result into severe injure, including death.
+ *
+ *
+ * Licensing terms:
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * a) This file is available under the Apache License, Version 2.0.
+ * b) When publishing any derivative work or results obtained using this software, you agree to cite the following paper:
+ *    Tomas Koutny and Martin Ubl, "SmartCGMS as a Testbed for a Blood-Glucose Level Prediction and/or 
+ *    Control Challenge with (an FDA-Accepted) Diabetic Patient Simulation", Procedia Computer Science,  
+ *    Volume 177, pp. 354-362, 2020
+ */
+
+#pragma once
+
+#include <scgms/iface/FilterIface.h>
+#include <scgms/rtl/FilterLib.h>
+#include <scgms/rtl/referencedImpl.h>
+
+#include <array>
+#include <vector>
+#include <memory>
+
+#if defined(ESP32) || defined(WASM)
+#include <atomic>
+#endif
+
+#if defined(ESP32)
+#include <mutex>
+#include <thread>
+#endif
+
+#pragma warning( push )
+#pragma warning( disable : 4250 ) // C4250 - 'class1' : inherits 'class2::member' via dominance 
+
+//Bounded multi-producer/multi-consumer queue of events (D. Vyukov's design - each cell carries its own sequence number).
+class CBounded_Event_Queue {
+public:
+	static constexpr size_t Capacity = 64;		//must be a power of two
+protected:
+#if defined(ESP32) || defined(WASM)
+	using TSequence = std::atomic<size_t>;
+#elif defined(FREERTOS)
+	using TSequence = size_t;
+#endif
+	struct TCell {
+		TSequence sequence;
+		scgms::IDevice_Event *event;
+	};
+
+	static constexpr size_t Mask = Capacity - 1;
+	static_assert((Capacity & Mask) == 0, "Capacity must be a power of two");
+
+	std::array<TCell, Capacity> mCells;
+	TSequence mEnqueue_Position{ 0 };
+	TSequence mDequeue_Position{ 0 };
+public:
+	CBounded_Event_Queue() noexcept;
+
+	bool Push(scgms::IDevice_Event *event) noexcept;		//false if full
+	bool Pop(scgms::IDevice_Event **event) noexcept;		//false if empty
+};
+
+class CFeedback_Channels;
+
+//Stands in for a feedback receiver, so that a sender executing within the chain enqueues the event instead of re-entering the chain.
+//The queued feedback is delivered once the outermost execute of the chain completes. The feedback sent from outside the chain,
+//e.g.; by a filter's own thread, goes to the receiver directly, as if there was no queue.
+class CFeedback_Queue : public virtual scgms::IFilter_Feedback_Receiver, public virtual refcnt::CNotReferenced {
+protected:
+	scgms::IFilter_Feedback_Receiver *mReceiver;	//owned by its filter executor, as with the direct sink
+	CFeedback_Channels &mChannels;
+	CBounded_Event_Queue mQueue;
+	//once the ring is full, the feedback keeps its order here rather than being dropped
+	std::vector<scgms::IDevice_Event*> mOverflow;
+#if defined(ESP32)
+	std::mutex mOverflow_Guard;
+#endif
+#if defined(ESP32) || defined(WASM)
+	std::atomic<bool> mClosed{ false };
+	std::atomic<bool> mOverflowed{ false };
+#elif defined(FREERTOS)
+	bool mClosed = false;
+	bool mOverflowed = false;
+#endif
+
+	bool Overflow(scgms::IDevice_Event *event) noexcept;	//false, if the event could not be stored
+	bool Drain_Overflow() noexcept;
+public:
+	CFeedback_Queue(scgms::IFilter_Feedback_Receiver *receiver, CFeedback_Channels &channels) noexcept;
+	virtual ~CFeedback_Queue();
+
+	//returns true if any event was delivered
+	bool Drain() noexcept;
+	//refuses any further feedback and releases the pending one; called before the receiver gets released
+	void Close() noexcept;
+
+	virtual HRESULT IfaceCalling Name(wchar_t** const name) override final;
+	virtual HRESULT IfaceCalling Configure(scgms::IFilter_Configuration* configuration, refcnt::wstr_list *error_description) override final;
+	virtual HRESULT IfaceCalling Execute(scgms::IDevice_Event *event) override final;	//enqueues within the chain, delivers directly otherwise
+};
+
+//Feedback queues of a single chain. The queues are drained when the outermost
+//CFilter_Executor::Execute of the chain completes, i.e.; without any recursion into the chain.
+class CFeedback_Channels {
+protected:
+	std::vector<std::unique_ptr<CFeedback_Queue>> mQueues;
+	size_t mExecute_Depth = 0;		//guarded by the chain's communication guard
+#if defined(ESP32)
+	std::atomic<std::thread::id> mExecuting_Thread{ std::thread::id{} };	//the one holding the communication guard, while executing
+#endif
+public:
+	CFeedback_Queue* Add_Receiver(scgms::IFilter_Feedback_Receiver *receiver);
+	void Close() noexcept;
+	void Clear() noexcept;
+
+	void Enter() noexcept;
+	void Leave() noexcept;
+	bool Executing() const noexcept;		//true, if the calling thread is executing the chain
+};
+
+#pragma warning( pop )
@@ -47,8 +47,8 @@ CFilter_Configuration_Executor::CFilter_Configuration_Executor(scgms::IFilter *c
 
 }
 
-HRESULT CFilter_Configuration_Executor::Build_Filter_Chain(scgms::IFilter_Chain_Configuration *configuration, scgms::TOn_Filter_Created on_filter_created, const void* on_filter_created_data, refcnt::Swstr_list& error_description) {
-	return mComposite_Filter.Build_Filter_Chain(configuration, &mTerminal_Filter, on_filter_created, on_filter_created_data, error_description);
+HRESULT CFilter_Configuration_Executor::Build_Filter_Chain(scgms::IFilter_Chain_Configuration *configuration, const scgms::NExecution_Flags execution_flags, scgms::TOn_Filter_Created on_filter_created, const void* on_filter_created_data, refcnt::Swstr_list& error_description, refcnt::Swstr_list& elided_filters) {
+	return mComposite_Filter.Build_Filter_Chain(configuration, &mTerminal_Filter, execution_flags, on_filter_created, on_filter_created_data, error_description, elided_filters);
 }
 
 
@@ -56,6 +56,17 @@ CFilter_Configuration_Executor::~CFilter_Configuration_Executor() {
 	Terminate(FALSE);
 }
 
+HRESULT IfaceCalling CFilter_Configuration_Executor::QueryInterface(const GUID*  riid, void ** ppvObj) {
+	if (Internal_Query_Interface<scgms::IReconfigurable_Filter_Executor>(scgms::IID_Reconfigurable_Filter_Executor, *riid, ppvObj)) return S_OK;
+
+	return E_NOINTERFACE;
+}
+
+HRESULT IfaceCalling CFilter_Configuration_Executor::Reconfigure(scgms::IFilter_Chain_Configuration *configuration, refcnt::wstr_list *error_description) {
+	refcnt::Swstr_list shared_error_description = refcnt::make_shared_reference_ext<refcnt::Swstr_list, refcnt::wstr_list>(error_description, true);
+	return mComposite_Filter.Reconfigure(configuration, shared_error_description);
+}
+
 HRESULT IfaceCalling CFilter_Configuration_Executor::Execute(scgms::IDevice_Event *event) {	
 	if (!event) return E_INVALIDARG;
 	return mComposite_Filter.Execute(event);    //also frees the event	
@@ -70,6 +81,10 @@ HRESULT IfaceCalling CFilter_Configuration_Executor::Terminate(const BOOL wait_f
 }
 
 DLL_EXPORT HRESULT IfaceCalling execute_filter_configuration(scgms::IFilter_Chain_Configuration *configuration, scgms::TOn_Filter_Created on_filter_created, const void* on_filter_created_data, scgms::IFilter *custom_output, scgms::IFilter_Executor **executor, refcnt::wstr_list *error_description) {
+	return execute_filter_configuration_ex(configuration, scgms::NExecution_Flags::None, on_filter_created, on_filter_created_data, custom_output, executor, error_description, nullptr);
+}
+
+DLL_EXPORT HRESULT IfaceCalling execute_filter_configuration_ex(scgms::IFilter_Chain_Configuration *configuration, const scgms::NExecution_Flags execution_flags, scgms::TOn_Filter_Created on_filter_created, const void* on_filter_created_data, scgms::IFilter *custom_output, scgms::IFilter_Executor **executor, refcnt::wstr_list *error_description, refcnt::wstr_list *elided_filters) {
 	std::unique_ptr<CFilter_Configuration_Executor> raw_executor = std::make_unique<CFilter_Configuration_Executor>(custom_output);
 	//increase the reference just in a case that we would be released prematurely in the Build_Filter_Chain call
 	*executor = static_cast<scgms::IFilter_Executor*>(raw_executor.get());
@@ -77,8 +92,9 @@ DLL_EXPORT HRESULT IfaceCalling execute_filter_configuration(scgms::IFilter_Chai
 
 
     refcnt::Swstr_list shared_error_description = refcnt::make_shared_reference_ext<refcnt::Swstr_list, refcnt::wstr_list>(error_description, true);
+	refcnt::Swstr_list shared_elided_filters = refcnt::make_shared_reference_ext<refcnt::Swstr_list, refcnt::wstr_list>(elided_filters, true);
 
-	HRESULT rc = raw_executor->Build_Filter_Chain(configuration, on_filter_created, on_filter_created_data, shared_error_description);
+	HRESULT rc = raw_executor->Build_Filter_Chain(configuration, execution_flags, on_filter_created, on_filter_created_data, shared_error_description, shared_elided_filters);
 	raw_executor.release();	//can release the unique pointer as it did its job and is needed no more
 
 	if (!Succeeded(rc)) {
@@ -48,7 +48,7 @@
 #pragma warning( disable : 4250 ) // C4250 - 'class1' : inherits 'class2::member' via dominance 
 
 
-class CFilter_Configuration_Executor : public virtual scgms::IFilter_Executor, public virtual refcnt::CReferenced {
+class CFilter_Configuration_Executor : public virtual scgms::IReconfigurable_Filter_Executor, public virtual refcnt::CReferenced {
 protected:
 #if defined(ESP32)
 	std::recursive_mutex mCommunication_Guard;
@@ -61,12 +61,16 @@ public:
 	CFilter_Configuration_Executor(scgms::IFilter *custom_output);
 	virtual ~CFilter_Configuration_Executor();
 
-	HRESULT Build_Filter_Chain(scgms::IFilter_Chain_Configuration *configuration, scgms::TOn_Filter_Created on_filter_created, const void* on_filter_created_data, refcnt::Swstr_list& error_description);
+	HRESULT Build_Filter_Chain(scgms::IFilter_Chain_Configuration *configuration, const scgms::NExecution_Flags execution_flags, scgms::TOn_Filter_Created on_filter_created, const void* on_filter_created_data, refcnt::Swstr_list& error_description, refcnt::Swstr_list& elided_filters);
+
+	virtual HRESULT IfaceCalling QueryInterface(const GUID*  riid, void ** ppvObj) override final;
 
 	virtual HRESULT IfaceCalling Execute(scgms::IDevice_Event *event) override final;
 	virtual HRESULT IfaceCalling Terminate(const BOOL wait_for_shutdown) override final;
+	virtual HRESULT IfaceCalling Reconfigure(scgms::IFilter_Chain_Configuration *configuration, refcnt::wstr_list *error_description) override final;
 };
 
 #pragma warning( pop )
 
 DLL_EXPORT HRESULT IfaceCalling execute_filter_configuration(scgms::IFilter_Chain_Configuration *configuration, scgms::TOn_Filter_Created on_filter_created, const void* on_filter_created_data, scgms::IFilter *custom_output, scgms::IFilter_Executor **executor, refcnt::wstr_list *error_description);
+DLL_EXPORT HRESULT IfaceCalling execute_filter_configuration_ex(scgms::IFilter_Chain_Configuration *configuration, const scgms::NExecution_Flags execution_flags, scgms::TOn_Filter_Created on_filter_created, const void* on_filter_created_data, scgms::IFilter *custom_output, scgms::IFilter_Executor **executor, refcnt::wstr_list *error_description, refcnt::wstr_list *elided_filters);
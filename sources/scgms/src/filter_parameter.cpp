@@ -59,7 +59,7 @@ HRESULT create_filter_parameter(const scgms::NParameter_Type type, const wchar_t
 }
 
 
-CFilter_Parameter::CFilter_Parameter(const scgms::NParameter_Type type, const wchar_t *config_name) : mType(type), mConfig_Name(config_name) {
+CFilter_Parameter::CFilter_Parameter(const scgms::NParameter_Type type, const wchar_t *config_name) : mType(type), mConfig_Name(intern_pool::Intern(config_name)) {
 	//
 }
 
@@ -69,8 +69,8 @@ HRESULT IfaceCalling CFilter_Parameter::Get_Type(scgms::NParameter_Type *type) {
 }
 
 HRESULT IfaceCalling CFilter_Parameter::Get_Config_Name(wchar_t **config_name) {
-	(*config_name) = const_cast<wchar_t*>(mConfig_Name.c_str());
-	return S_OK;
+	(*config_name) = const_cast<wchar_t*>(mConfig_Name);
+	return mConfig_Name ? S_OK : E_NOT_SET;
 }
 
 HRESULT IfaceCalling CFilter_Parameter::Get_WChar_Container(refcnt::wstr_container **wstr, BOOL read_interpreted) {
@@ -93,11 +93,18 @@ HRESULT IfaceCalling CFilter_Parameter::Set_WChar_Container(refcnt::wstr_contain
 
 
 HRESULT IfaceCalling CFilter_Parameter::Get_Time_Segment_Id_Container(scgms::time_segment_id_container **ids) {
+	const HRESULT rc = Parse_Pending();
+	if (rc != S_OK) {
+		*ids = nullptr;
+		return rc;
+	}
+
 	return Get_Container_With_All_Level_Vars_Evaluated<scgms::time_segment_id_container, int64_t>(mTime_Segment_ID, ids, str_2_int);
 }
 
 HRESULT IfaceCalling CFilter_Parameter::Set_Time_Segment_Id_Container(scgms::time_segment_id_container *ids) {
 	//by setting this to max, we effectively discard any nested variable and do not need to perform any additinal action
+	Discard_Pending();
 	mFirst_Array_Var_idx = std::numeric_limits<size_t>::max();
 	mVariable_Name.clear();
 
@@ -106,61 +113,72 @@ HRESULT IfaceCalling CFilter_Parameter::Set_Time_Segment_Id_Container(scgms::tim
 }
 
 HRESULT IfaceCalling CFilter_Parameter::Get_Double(double *value) {
-	return Get_Value<double>(value, [this]() {return mData.dbl; }, [](const std::wstring& var_val, bool& ok) {
+	return Get_Value<double>(value, [this]() {return mData.dbl; }, [this](const double &val) {mData.dbl = val; }, [](const std::wstring& var_val, bool& ok) {
 			return str_2_rat_dbl(var_val, ok);
 		},
 		std::numeric_limits<double>::quiet_NaN());
 }
 
 HRESULT IfaceCalling CFilter_Parameter::Set_Double(const double value) {
+	Discard_Pending();
 	mVariable_Name.clear();
 	mData.dbl = value;
 	return S_OK;
 }
 
 HRESULT IfaceCalling CFilter_Parameter::Get_Int64(int64_t *value) {
-	return Get_Value<int64_t>(value, [this]() {return mData.int64; }, [](const std::wstring& var_val, bool& ok) {
+	return Get_Value<int64_t>(value, [this]() {return mData.int64; }, [this](const int64_t &val) {mData.int64 = val; }, [](const std::wstring& var_val, bool& ok) {
 		return str_2_int(var_val.c_str(), ok);		
 	}, std::numeric_limits<int64_t>::max());
 }
 
 HRESULT IfaceCalling CFilter_Parameter::Set_Int64(const int64_t value) {
+	Discard_Pending();
 	mVariable_Name.clear();
 	mData.int64 = value;
 	return S_OK;
 }
 
 HRESULT IfaceCalling CFilter_Parameter::Get_Bool(BOOL *boolean) {
-	return Get_Value<BOOL>(boolean, [this]() {return mData.boolean ? TRUE : FALSE; }, [](const std::wstring& var_val, bool& ok) {
+	return Get_Value<BOOL>(boolean, [this]() {return mData.boolean ? TRUE : FALSE; }, [this](const BOOL &val) {mData.boolean = val != FALSE; }, [](const std::wstring& var_val, bool& ok) {
 		const bool val = str_2_bool(var_val, ok);
 		return val ? TRUE : FALSE;
 	}, false);
 }
 
 HRESULT IfaceCalling CFilter_Parameter::Set_Bool(const BOOL boolean) {
+	Discard_Pending();
 	mVariable_Name.clear();
 	mData.boolean = boolean != FALSE;
 	return S_OK;
 }
 
 HRESULT IfaceCalling CFilter_Parameter::Get_GUID(GUID *id) {
-	return Get_Value<GUID>(id, [this]() {return mData.guid; }, [](const std::wstring& var_val, bool& ok) {
+	return Get_Value<GUID>(id, [this]() {return mData.guid; }, [this](const GUID &val) {mData.guid = val; }, [](const std::wstring& var_val, bool& ok) {
 		return WString_To_GUID(var_val, ok);
 	}, Invalid_GUID);
 }
 
 HRESULT IfaceCalling CFilter_Parameter::Set_GUID(const GUID *id) {
+	Discard_Pending();
 	mVariable_Name.clear();
 	mData.guid = *id;
 	return S_OK;
 }
 
 HRESULT IfaceCalling CFilter_Parameter::Get_Model_Parameters(scgms::IModel_Parameter_Vector **parameters) {
+	const HRESULT rc = Parse_Pending();
+	if (rc != S_OK) {
+		*parameters = nullptr;
+		return rc;
+	}
+
 	return Get_Container_With_All_Level_Vars_Evaluated<scgms::IModel_Parameter_Vector, double>(mModel_Parameters, parameters, str_2_rat_dbl);
 }
 
 HRESULT IfaceCalling CFilter_Parameter::Set_Model_Parameters(scgms::IModel_Parameter_Vector *parameters) {
 	//by setting this to max, we effectively discard any nested variable and do not need to perform any additinal action
+	Discard_Pending();
 	mFirst_Array_Var_idx = std::numeric_limits<size_t>::max();
 	mVariable_Name.clear();
 	mArray_Vars.clear();
@@ -171,7 +189,7 @@ HRESULT IfaceCalling CFilter_Parameter::Set_Model_Parameters(scgms::IModel_Param
 
 
 HRESULT IfaceCalling CFilter_Parameter::Clone(scgms::IFilter_Parameter **deep_copy) {
-	std::unique_ptr<CFilter_Parameter> clone = std::make_unique<CFilter_Parameter>(mType, mConfig_Name.c_str());
+	std::unique_ptr<CFilter_Parameter> clone = std::make_unique<CFilter_Parameter>(mType, mConfig_Name);
 	clone->mVariable_Name = mVariable_Name;
 	clone->mWChar_Container = refcnt::Copy_Container_shared<wchar_t, decltype(mWChar_Container)>(mWChar_Container.get());
 	clone->mArray_Vars = mArray_Vars;
@@ -182,6 +200,11 @@ HRESULT IfaceCalling CFilter_Parameter::Clone(scgms::IFilter_Parameter **deep_co
 	clone->mNon_OS_Variables = mNon_OS_Variables;
 
 	clone->mDeferred_Path_Or_Var = mDeferred_Path_Or_Var;
+	clone->mVariable_Table = mVariable_Table;
+	clone->mLocal_Variables_Version = mLocal_Variables_Version;
+	clone->mPending_Text = mPending_Text;
+	clone->mParsing_Pending = mParsing_Pending;
+	clone->mParse_Result = mParse_Result;
 
 	(*deep_copy) = static_cast<scgms::IFilter_Parameter*>(clone.get());
 	(*deep_copy)->AddRef();
@@ -193,6 +216,7 @@ HRESULT IfaceCalling CFilter_Parameter::Clone(scgms::IFilter_Parameter **deep_co
 HRESULT IfaceCalling CFilter_Parameter::Set_Variable(const wchar_t* name, const wchar_t* value) {
 	if (name == CFilter_Parameter::mUnused_Variable_Name) return TYPE_E_AMBIGUOUSNAME;
 	mNon_OS_Variables[name] = value;
+	mLocal_Variables_Version++;
 	return S_OK;
 }
 
@@ -209,6 +233,13 @@ std::tuple<HRESULT, std::wstring> CFilter_Parameter::Evaluate_Variable(const std
 			return std::tuple<bool, std::wstring>{S_OK, iter->second};
 	}
 
+	//then the chain's ones
+	if (mVariable_Table) {
+		auto chain_variable = mVariable_Table->Get(var_name);
+		if (std::get<0>(chain_variable) == S_OK)
+			return chain_variable;
+	}
+
 	//try OS variables
 	{
 		std::string ansi = Narrow_WString(var_name);
@@ -229,9 +260,14 @@ std::tuple<HRESULT, std::wstring> CFilter_Parameter::Evaluate_Variable(const std
 	return { E_NOT_SET, std::wstring{} };	//not found at all
 }
 
+HRESULT IfaceCalling CFilter_Parameter::Validate() {
+	return Parse_Pending();
+}
+
 HRESULT CFilter_Parameter::from_string(const scgms::NParameter_Type desired_type, const wchar_t* str) {
 	wchar_t* effective_str = const_cast<wchar_t*>(str);
 	
+	Discard_Pending();
 	mDeferred_Path_Or_Var.clear();
 
 
@@ -302,10 +338,90 @@ HRESULT CFilter_Parameter::from_string(const scgms::NParameter_Type desired_type
 }
 
 
+void CFilter_Parameter::Reference_Variable(const std::wstring& var_name) {
+	Discard_Pending();
+	mDeferred_Path_Or_Var.clear();
+	mVariable_Name = var_name;
+}
+
+
+void CFilter_Parameter::Defer_Parsing(const std::string_view utf8_str) {
+	Discard_Pending();
+#if defined(SCGMS_UTF8_STRINGS)
+	mPending_Text = utf8_str;
+#else
+	mPending_Text = Widen_UTF8(utf8_str);
+#endif
+	mParsing_Pending = true;
+}
+
+
+HRESULT CFilter_Parameter::Parse_Pending() {
+	if (mParsing_Pending) {
+		auto text = std::move(mPending_Text);
+		const HRESULT rc = from_string(mType, Pending_To_WString(text).c_str());	//from_string discards the pending state
+		if (rc != S_OK)
+			mPending_Text = std::move(text);	//keep it to describe the malformed value
+		mParse_Result = rc;
+	}
+
+	return mParse_Result;
+}
+
+
+void CFilter_Parameter::Discard_Pending() {
+	mPending_Text.clear();
+	mParsing_Pending = false;
+	mParse_Result = S_OK;
+
+	//and whatever variables the previous value has referenced
+	mVariable_Handles_Bound = false;
+	mEvaluated_Version = 0;
+}
+
+
+void CFilter_Parameter::Bind_Variables(std::shared_ptr<CVariable_Table> table) {
+	mVariable_Table = std::move(table);
+	mVariable_Handles_Bound = false;
+	mEvaluated_Version = 0;
+}
+
+
+uint64_t CFilter_Parameter::Variables_Version() {
+	//OS variables are not tracked, hence they are read just once with the table
+	//but on every read without it
+	if (!mVariable_Table)
+		return 0;
+
+	if (!mVariable_Handles_Bound) {
+		mVariable_Handles.clear();
+		if (!mVariable_Name.empty())
+			mVariable_Handles.push_back(mVariable_Table->Bind(mVariable_Name));
+		for (const auto &var_name : mArray_Vars)
+			if (!var_name.empty())
+				mVariable_Handles.push_back(mVariable_Table->Bind(var_name));
+		mVariable_Handles_Bound = true;
+	}
+
+	//the versions only grow, so does their sum with any change
+	uint64_t version = mLocal_Variables_Version + 1;
+	for (const auto handle : mVariable_Handles)
+		version += mVariable_Table->Version(handle);
+
+	return version;
+}
+
+
 std::tuple<HRESULT, std::wstring> CFilter_Parameter::to_string(bool read_interpreted) {
 	
+	//the loaded text is what the value would be written as anyway, unless it gets interpreted
+	if (!read_interpreted && !mPending_Text.empty())
+		return std::tuple<HRESULT, std::wstring>{S_OK, Pending_To_WString(mPending_Text)};
+
 	std::wstring converted;
-	HRESULT rc = S_OK;
+	HRESULT rc = Parse_Pending();
+	if (rc != S_OK)
+		return std::tuple<HRESULT, std::wstring>{rc, converted};
 	
 	auto convert_scalar = [&]() {
 		if (mVariable_Name.empty()) {
@@ -362,7 +478,9 @@ std::tuple<HRESULT, std::wstring> CFilter_Parameter::to_string(bool read_interpr
 
 		case scgms::NParameter_Type::ptDouble_Array: 
 			{							
-				if (!mModel_Parameters && (!mDeferred_Path_Or_Var.empty()))	//if we have not evaluated the array yet
+				if (!mVariable_Name.empty())
+					convert_scalar();	//the container holds the variable's value
+				else if (!mModel_Parameters && (!mDeferred_Path_Or_Var.empty()))	//if we have not evaluated the array yet
 						rc = S_OK;
 				else
 						std::tie(rc, converted) = Array_To_String<double>(mModel_Parameters.get(), read_interpreted);
@@ -371,7 +489,9 @@ std::tuple<HRESULT, std::wstring> CFilter_Parameter::to_string(bool read_interpr
 
 		case scgms::NParameter_Type::ptInt64_Array:
 			{
-				if (!mTime_Segment_ID && (!mDeferred_Path_Or_Var.empty()))
+				if (!mVariable_Name.empty())
+					convert_scalar();
+				else if (!mTime_Segment_ID && (!mDeferred_Path_Or_Var.empty()))
 					rc = S_OK;
 				else
 					std::tie(rc, converted) = Array_To_String<int64_t>(mTime_Segment_ID.get(), read_interpreted);
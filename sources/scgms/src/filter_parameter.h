@@ -40,7 +40,12 @@
 #include <scgms/rtl/referencedImpl.h>
 #include <scgms/utils/string_utils.h>
 
+#include "variable_table.h"
+#include "intern_pool.h"
+#include "configuration_arena.h"
+
 #include <map>
+#include <memory>
 #include <iostream>
 #include <iomanip>
 #include <sstream>
@@ -49,13 +54,13 @@
 #pragma warning( push )
 #pragma warning( disable : 4250 ) // C4250 - 'class1' : inherits 'class2::member' via dominance 
 
-class CFilter_Parameter : public virtual scgms::IFilter_Parameter, public virtual refcnt::CReferenced {
+class CFilter_Parameter : public virtual scgms::IFilter_Parameter, public virtual refcnt::CReferenced, public CArena_Allocated {
 protected:
 	template <typename T>
 	using TConvertor = T(*)(const std::wstring&, bool&);
 protected:
 	const scgms::NParameter_Type mType;
-	const std::wstring mConfig_Name;
+	const intern_pool::TString mConfig_Name;	//shared by all the parameters of the same name
 	//filesystem::path mParent_Path;
 
 	//the following SReferenced variables are not part of the union to prevent memory corruption
@@ -93,8 +98,8 @@ protected:
 		D *current, *end;
 		HRESULT rc = container->get(&current, &end);
 		if (rc == S_OK) {
+			const size_t cnt = std::distance(current, end);
 			current += mFirst_Array_Var_idx;
-			const size_t cnt = std::distance(current , end);
 			for (size_t var_idx = mFirst_Array_Var_idx; var_idx < cnt; var_idx++) {
 				if (!mArray_Vars[var_idx].empty()) {
 					std::wstring str_val;
@@ -118,13 +123,25 @@ protected:
 	}
 	
 
-	template <typename T, typename getter=T(*)()>
-	HRESULT Get_Value(T* value, getter get_val, TConvertor<T> conv, const T&sanity_val) {
-		HRESULT rc = S_OK;
+	template <typename T, typename getter=T(*)(), typename setter=void(*)(const T&)>
+	HRESULT Get_Value(T* value, getter get_val, setter set_val, TConvertor<T> conv, const T&sanity_val) {
+		HRESULT rc = Parse_Pending();
+		if (rc != S_OK) {
+			*value = sanity_val;
+			return rc;
+		}
+
 		if (mVariable_Name.empty()) {
 			*value = get_val();
 		}
 		else {			
+			//mData caches the variable's value, as long as the variable does not change
+			const uint64_t version = Variables_Version();
+			if ((version != 0) && (version == mEvaluated_Version)) {
+				*value = get_val();
+				return S_OK;
+			}
+
 			std::wstring var_val;
 			std::tie(rc, var_val) = Evaluate_Variable(mVariable_Name);
 
@@ -136,6 +153,10 @@ protected:
 					rc = E_INVALIDARG;
 					*value = sanity_val;
 				}
+				else if (rc == S_OK) {
+					set_val(*value);
+					mEvaluated_Version = version;
+				}
 			}
 			else {
 				*value = sanity_val; 				
@@ -147,7 +168,7 @@ protected:
 
 
 	template <typename C, typename D>
-	HRESULT Get_Container_With_All_Level_Vars_Evaluated(refcnt::SReferenced<C> source_container, C** destination_container, TConvertor<D> conv) {
+	HRESULT Get_Container_With_All_Level_Vars_Evaluated(refcnt::SReferenced<C> &source_container, C** destination_container, TConvertor<D> conv) {
 		HRESULT rc = Evaluate_Container_Variables(source_container, conv);
 		if (Succeeded(rc)) {
 			rc = Get_Container<refcnt::SReferenced<C>, C**>(source_container, destination_container);
@@ -158,6 +179,11 @@ protected:
 
 	template <typename C, typename D>
 	HRESULT Evaluate_Container_Variables(refcnt::SReferenced<C> &source_container, TConvertor<D> conv) {
+		//the container keeps the values of the variables, as long as they do not change
+		const uint64_t version = Variables_Version();
+		if (source_container && (version != 0) && (version == mEvaluated_Version))
+			return S_OK;
+
 		//let's check whether str is or is not a variable
 		if (!mVariable_Name.empty()) {
 			//let us update re-parse the container
@@ -171,11 +197,16 @@ protected:
 			if (!Parse_Container<C, D>(source_container, current_value, conv))
 				return E_FAIL;
 
+			if (local_rc == S_OK)
+				mEvaluated_Version = version;
 			return S_OK;
 
 		}
 		else if (source_container) {
-			return Update_Container_By_Vars<D, refcnt::SReferenced<C>>(source_container, conv);
+			const HRESULT rc = Update_Container_By_Vars<D, refcnt::SReferenced<C>>(source_container, conv);
+			if (rc == S_OK)
+				mEvaluated_Version = version;
+			return rc;
 		}
 		else
 			return E_NOT_SET;
@@ -196,6 +227,8 @@ protected:
 		std::vector<D> values;
 		mArray_Vars.clear();
 		mFirst_Array_Var_idx = std::numeric_limits<size_t>::max();
+		mVariable_Handles_Bound = false;
+		mEvaluated_Version = 0;
 
 		//std::wstring effective_str{ str };	//wcstok modifies the input string
 		const wchar_t* delimiters = L" \r\n";	//string of chars, which designate individual delimiters
@@ -236,15 +269,7 @@ protected:
 		
 		//values converted and nested variable names noted
 		//=> create and return its container
-		R* obj = nullptr;
-		if (Manufacture_Object<refcnt::internal::CVector_Container<D>, R>(&obj) == S_OK) {
-			if (obj->set(values.data(), values.data() + values.size()) != S_OK) {
-				obj->Release();
-				obj = nullptr;
-			};
-		}
-
-		return obj;
+		return refcnt::Create_Container<D>(values.data(), values.data() + values.size());
 	}
 
 
@@ -289,6 +314,8 @@ protected:
 				else {
 					converted << *iter;
 				}
+
+				var_idx++;
 			}
 		}
 
@@ -299,10 +326,31 @@ protected:
 
 protected:
 	std::tuple<HRESULT, std::wstring> to_string(bool read_interpreted);
+protected:
+	//the text given to Defer_Parsing, kept until it is parsed successfully
+#if defined(SCGMS_UTF8_STRINGS)
+	std::string mPending_Text;		//as loaded, widened once parsed
+	static std::wstring Pending_To_WString(const std::string &text) { return Widen_UTF8(text); }
+#else
+	std::wstring mPending_Text;
+	static const std::wstring& Pending_To_WString(const std::wstring &text) { return text; }
+#endif
+	bool mParsing_Pending = false;
+	HRESULT mParse_Result = S_OK;
+	HRESULT Parse_Pending();	//parses mPending_Text on the first read
+	void Discard_Pending();		//a value has been set explicitly
 protected:
 	std::wstring mVariable_Name;
 	std::map<std::wstring, std::wstring> mNon_OS_Variables;
 	std::tuple<HRESULT, std::wstring> Evaluate_Variable(const std::wstring &var_name);
+protected:
+	//chain-level variables; without the table, the variables are evaluated on every read
+	std::shared_ptr<CVariable_Table> mVariable_Table;
+	std::vector<CVariable_Table::THandle> mVariable_Handles;	//of mVariable_Name and mArray_Vars
+	bool mVariable_Handles_Bound = false;
+	uint64_t mLocal_Variables_Version = 0;		//Set_Variable on this very parameter
+	uint64_t mEvaluated_Version = 0;			//of the variables, when the cached value was evaluated; 0 if none
+	uint64_t Variables_Version();				//0 if the evaluated value cannot be cached
 protected:
 	std::wstring mDeferred_Path_Or_Var;	//wstring so that we can pass its c_str when Get_Deffered_File gets called
 	const wchar_t* mDeferred_Magic_String_Prefix = L"$([[deferred to]]";
@@ -324,6 +372,9 @@ public:
 
 	//conversion
 	HRESULT from_string(const scgms::NParameter_Type desired_type, const wchar_t* str);
+	void Reference_Variable(const std::wstring& var_name);	//the same as from_string with $(var_name), but without parsing it
+	void Defer_Parsing(const std::string_view utf8_str);		//from_string, postponed until the value is read or validated
+	void Bind_Variables(std::shared_ptr<CVariable_Table> table);
 
 	virtual HRESULT IfaceCalling Get_Type(scgms::NParameter_Type *type) override final;
 	virtual HRESULT IfaceCalling Get_Config_Name(wchar_t **config_name) override final;
@@ -357,6 +408,7 @@ public:
 
 	//management
 	virtual HRESULT IfaceCalling Clone(scgms::IFilter_Parameter **deep_copy) override final;
+	virtual HRESULT IfaceCalling Validate() override final;
 public:
 	static const std::wstring mUnused_Variable_Name;
 };
@@ -0,0 +1,104 @@
+/**
+ * SmartCGMS - continuous glucose monitoring and controlling framework
+ * https://diabetes.zcu.cz/
+ *
+ * Copyright (c) since 2018 University of West Bohemia.
+ *
+ * Contact:
+ * diabetes@mail.kiv.zcu.cz
+ * Medical Informatics, Department of Computer Science and Engineering
+ * Faculty of Applied Sciences, University of West Bohemia
+ * Univerzitni 8, 301 00 Pilsen
+ * Czech Republic
+ * 
+ * 
+ * Purpose of this software:
+ * This software is intended to demonstrate work of the diabetes.zcu.cz research
+ * group to other scientists, to complement our published papers. It is strictly
+ * prohibited to use this software for diagnosis or treatment of any medical condition,
+ * without obtaining all required approvals from respective regulatory bodies.
+ *
+ * Especially, a diabetic patient is warned that unauthorized use of this software
+ * may result into severe injure, including death.
+ *
+ *
+ * Licensing terms:
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * a) This file is available under the Apache License, Version 2.0.
+ * b) When publishing any derivative work or results obtained using this software, you agree to cite the following paper:
+ *    Tomas Koutny and Martin Ubl, "SmartCGMS as a Testbed for a Blood-Glucose Level Prediction and/or 
+ *    Control Challenge with (an FDA-Accepted) Diabetic Patient Simulation", Procedia Computer Science,  
+ *    Volume 177, pp. 354-362, 2020
+ */
+
+#include "intern_pool.h"
+
+#include <deque>
+#include <string_view>
+#include <unordered_set>
+
+#if defined(ESP32)
+#include <mutex>
+#endif
+
+namespace {
+	struct TPool {
+		std::deque<std::wstring> storage;				//deque does not relocate the strings it already holds
+		std::unordered_set<std::wstring_view> strings;	//views into the storage, so that the lookup does not allocate
+#if defined(ESP32)
+		std::mutex guard;
+#endif
+	};
+
+	TPool& Pool() {
+		static TPool pool;	//constructed on the first use, as the descriptors could be interned during the static initialization
+		return pool;
+	}
+}
+
+namespace intern_pool {
+
+	TString Intern(const wchar_t* str) {
+		if (!str) return nullptr;
+
+		TPool& pool = Pool();
+		const std::wstring_view view{ str };
+
+#if defined(ESP32)
+		std::lock_guard<std::mutex> guard{ pool.guard };
+#endif
+		auto iter = pool.strings.find(view);
+		if (iter != pool.strings.end())
+			return iter->data();
+
+		const std::wstring& stored = pool.storage.emplace_back(view);
+		pool.strings.insert(std::wstring_view{ stored });
+		return stored.c_str();
+	}
+
+	TString Intern(const std::wstring& str) {
+		return Intern(str.c_str());
+	}
+
+	TString Find(const wchar_t* str) {
+		if (!str) return nullptr;
+
+		TPool& pool = Pool();
+#if defined(ESP32)
+		std::lock_guard<std::mutex> guard{ pool.guard };
+#endif
+		auto iter = pool.strings.find(std::wstring_view{ str });
+		return iter != pool.strings.end() ? iter->data() : nullptr;
+	}
+
+	size_t Count() {
+		TPool& pool = Pool();
+#if defined(ESP32)
+		std::lock_guard<std::mutex> guard{ pool.guard };
+#endif
+		return pool.storage.size();
+	}
+}
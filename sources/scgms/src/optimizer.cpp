@@ -0,0 +1,389 @@
+/**
+ * SmartCGMS - continuous glucose monitoring and controlling framework
+ * https://diabetes.zcu.cz/
+ *
+ * Copyright (c) since 2018 University of West Bohemia.
+ *
+ * Contact:
+ * diabetes@mail.kiv.zcu.cz
+ * Medical Informatics, Department of Computer Science and Engineering
+ * Faculty of Applied Sciences, University of West Bohemia
+ * Univerzitni 8, 301 00 Pilsen
+ * Czech Republic
+ * 
+ * 
+ * Purpose of this software:
+ * This software is intended to demonstrate work of the diabetes.zcu.cz research
+ * group to other scientists, to complement our published papers. It is strictly
+ * prohibited to use this software for diagnosis or treatment of any medical condition,
+ * without obtaining all required approvals from respective regulatory bodies.
+ *
+ * Especially, a diabetic patient is warned that unauthorized use of this software
+ * may result into severe injure, including death.
+ *
+ *
+ * Licensing terms:
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * a) This file is available under the Apache License, Version 2.0.
+ * b) When publishing any derivative work or results obtained using this software, you agree to cite the following paper:
+ *    Tomas Koutny and Martin Ubl, "SmartCGMS as a Testbed for a Blood-Glucose Level Prediction and/or 
+ *    Control Challenge with (an FDA-Accepted) Diabetic Patient Simulation", Procedia Computer Science,  
+ *    Volume 177, pp. 354-362, 2020
+ */
+
+#include "optimizer.h"
+#include "persistent_chain_configuration.h"
+#include "configuration_link.h"
+#include "filter_configuration_executor.h"
+#include "worker_pool.h"
+
+#include <scgms/rtl/FilterLib.h>
+#include <scgms/rtl/referencedImpl.h>
+#include <scgms/lang/dstrings.h>
+
+#include <vector>
+#include <string>
+#include <random>
+#include <limits>
+#include <algorithm>
+#include <cmath>
+#include <cwchar>
+
+#if defined(ESP32)
+#include <mutex>
+#endif
+
+namespace {
+
+	constexpr double Differential_Weight = 0.8;
+	constexpr double Crossover_Probability = 0.9;
+	constexpr size_t Minimal_Population_Size = 4;		//rand/1 mutation needs three other members
+
+	struct TOptimized_Parameter {
+		size_t filter_index;
+		std::wstring configuration_name;
+		size_t first_dimension;		//offset within the solution vector
+		size_t dimension_count;		//length of each of the lower-bound, default and upper-bound sections
+	};
+
+	struct TCandidate_Evaluation {
+		scgms::TOn_Filter_Created on_filter_created;
+		const void* on_filter_created_data;
+#if defined(ESP32)
+		std::mutex &on_filter_created_guard;		//the candidates are evaluated concurrently, the caller's callback is not
+#endif
+		double metric;
+		bool metric_promised;
+	};
+
+	HRESULT IfaceCalling On_Candidate_Filter_Created(scgms::IFilter *filter, const void* data) {
+		TCandidate_Evaluation *evaluation = reinterpret_cast<TCandidate_Evaluation*>(const_cast<void*>(data));
+
+		if (evaluation->on_filter_created) {
+#if defined(ESP32)
+			std::lock_guard<std::mutex> guard{ evaluation->on_filter_created_guard };
+#endif
+			const HRESULT rc = evaluation->on_filter_created(filter, evaluation->on_filter_created_data);
+			if (!Succeeded(rc)) return rc;
+		}
+
+		//filters are created from the last one, so that we promise the metric of the signal error filter closest to the chain's end
+		if (!evaluation->metric_promised) {
+			refcnt::SReferenced<scgms::ISignal_Error_Inspection> inspection;
+			refcnt::Query_Interface<scgms::IFilter, scgms::ISignal_Error_Inspection>(filter, scgms::IID_Signal_Error_Inspection, inspection);
+			if (inspection)
+				evaluation->metric_promised = inspection->Promise_Metric(scgms::All_Segments_Id, &evaluation->metric, TRUE) == S_OK;
+		}
+
+		return S_OK;
+	}
+
+	scgms::IFilter_Parameter* Find_Parameter(scgms::IFilter_Chain_Configuration *configuration, const size_t filter_index, const wchar_t *configuration_name) {
+		scgms::IFilter_Configuration_Link **link_begin, **link_end;
+		if (configuration->get(&link_begin, &link_end) != S_OK) return nullptr;
+		if (filter_index >= static_cast<size_t>(std::distance(link_begin, link_end))) return nullptr;
+
+		scgms::IFilter_Parameter **param_begin, **param_end;
+		if (link_begin[filter_index]->get(&param_begin, &param_end) != S_OK) return nullptr;
+
+		for (; param_begin != param_end; param_begin++) {
+			wchar_t *name;
+			if (((*param_begin)->Get_Config_Name(&name) == S_OK) && (wcscmp(name, configuration_name) == 0))
+				return *param_begin;
+		}
+
+		return nullptr;
+	}
+
+	class CParameters_Optimizer {
+	protected:
+		scgms::IFilter_Chain_Configuration *mConfiguration;
+		scgms::TOn_Filter_Created mOn_Filter_Created;
+		const void* mOn_Filter_Created_Data;
+#if defined(ESP32)
+		mutable std::mutex mOn_Filter_Created_Guard;
+#endif
+
+		std::vector<TOptimized_Parameter> mParameters;
+		std::vector<double> mLower_Bound, mDefault_Solution, mUpper_Bound;	//concatenated over all the optimized parameters
+
+		HRESULT Clone_Configuration(refcnt::SReferenced<scgms::IFilter_Chain_Configuration> &clone) const;
+		HRESULT Write_Solution(scgms::IFilter_Chain_Configuration *configuration, const std::vector<double> &solution) const;
+		double Evaluate(const std::vector<double> &solution, refcnt::wstr_list *error_description) const;
+	public:
+		CParameters_Optimizer(scgms::IFilter_Chain_Configuration *configuration, scgms::TOn_Filter_Created on_filter_created, const void* on_filter_created_data);
+
+		HRESULT Read_Parameters(const size_t *filter_indices, const wchar_t **parameters_configuration_names, const size_t filter_count, refcnt::Swstr_list &error_description);
+		HRESULT Optimize(const size_t population_size, const size_t max_generations, solver::TSolver_Progress &progress, refcnt::Swstr_list &error_description);
+	};
+
+	CParameters_Optimizer::CParameters_Optimizer(scgms::IFilter_Chain_Configuration *configuration, scgms::TOn_Filter_Created on_filter_created, const void* on_filter_created_data) :
+		mConfiguration(configuration), mOn_Filter_Created(on_filter_created), mOn_Filter_Created_Data(on_filter_created_data) {
+		//
+	}
+
+	HRESULT CParameters_Optimizer::Read_Parameters(const size_t *filter_indices, const wchar_t **parameters_configuration_names, const size_t filter_count, refcnt::Swstr_list &error_description) {
+		for (size_t i = 0; i < filter_count; i++) {
+			scgms::IFilter_Parameter *parameter = Find_Parameter(mConfiguration, filter_indices[i], parameters_configuration_names[i]);
+			if (!parameter) {
+				error_description.push(dsParameters_to_optimize_not_found);
+				return E_INVALIDARG;
+			}
+
+			scgms::IModel_Parameter_Vector *raw_parameters = nullptr;
+			if (parameter->Get_Model_Parameters(&raw_parameters) != S_OK) {
+				error_description.push(dsParameters_to_optimize_could_not_be_read_bounds_including);
+				return E_INVALIDARG;
+			}
+
+			refcnt::SReferenced<scgms::IModel_Parameter_Vector> parameters = refcnt::make_shared_reference_ext<refcnt::SReferenced<scgms::IModel_Parameter_Vector>, scgms::IModel_Parameter_Vector>(raw_parameters, false);
+			double *begin, *end;
+			if ((parameters->get(&begin, &end) != S_OK) || (std::distance(begin, end) % 3 != 0)) {
+				error_description.push(dsParameters_to_optimize_could_not_be_read_bounds_including);
+				return E_INVALIDARG;
+			}
+
+			const size_t dimension_count = std::distance(begin, end) / 3;
+			mParameters.push_back(TOptimized_Parameter{ filter_indices[i], parameters_configuration_names[i], mDefault_Solution.size(), dimension_count });
+			mLower_Bound.insert(mLower_Bound.end(), begin, begin + dimension_count);
+			mDefault_Solution.insert(mDefault_Solution.end(), begin + dimension_count, begin + 2 * dimension_count);
+			mUpper_Bound.insert(mUpper_Bound.end(), begin + 2 * dimension_count, end);
+		}
+
+		return mDefault_Solution.empty() ? E_INVALIDARG : S_OK;
+	}
+
+	HRESULT CParameters_Optimizer::Clone_Configuration(refcnt::SReferenced<scgms::IFilter_Chain_Configuration> &clone) const {
+		scgms::IPersistent_Filter_Chain_Configuration *raw_clone = nullptr;
+		HRESULT rc = create_persistent_filter_chain_configuration(&raw_clone);
+		if (rc != S_OK) return rc;
+		clone = refcnt::make_shared_reference_ext<refcnt::SReferenced<scgms::IFilter_Chain_Configuration>, scgms::IFilter_Chain_Configuration>(raw_clone, false);
+
+		//the chain's variables live in the chain's table, not in the parameters
+		const CPersistent_Chain_Configuration *original = dynamic_cast<const CPersistent_Chain_Configuration*>(mConfiguration);
+		CPersistent_Chain_Configuration *persistent_clone = dynamic_cast<CPersistent_Chain_Configuration*>(raw_clone);
+		if (original && persistent_clone) {
+			rc = persistent_clone->Copy_Variables(*original);
+			if (!Succeeded(rc)) return rc;
+		}
+
+		scgms::IFilter_Configuration_Link **link_begin, **link_end;
+		rc = mConfiguration->get(&link_begin, &link_end);
+		if (rc != S_OK) return rc;
+
+		for (; link_begin != link_end; link_begin++) {
+			GUID filter_id;
+			rc = (*link_begin)->Get_Filter_Id(&filter_id);
+			if (rc != S_OK) return rc;
+
+			scgms::IFilter_Configuration_Link *raw_link = nullptr;
+			rc = create_filter_configuration_link(&filter_id, &raw_link);
+			if (rc != S_OK) return rc;
+			scgms::SFilter_Configuration_Link link = refcnt::make_shared_reference_ext<scgms::SFilter_Configuration_Link, scgms::IFilter_Configuration_Link>(raw_link, false);
+
+			scgms::IFilter_Parameter **param_begin, **param_end;
+			rc = (*link_begin)->get(&param_begin, &param_end);
+			if (!Succeeded(rc)) return rc;
+
+			if (rc == S_OK) {
+				for (; param_begin != param_end; param_begin++) {
+					scgms::IFilter_Parameter *raw_parameter = nullptr;
+					rc = (*param_begin)->Clone(&raw_parameter);
+					if (rc != S_OK) return rc;
+
+					rc = link->add(&raw_parameter, &raw_parameter + 1);
+					raw_parameter->Release();	//add took its own reference
+					if (!Succeeded(rc)) return rc;
+				}
+			}
+
+			rc = clone->add(&raw_link, &raw_link + 1);
+			if (!Succeeded(rc)) return rc;
+		}
+
+		return S_OK;
+	}
+
+	HRESULT CParameters_Optimizer::Write_Solution(scgms::IFilter_Chain_Configuration *configuration, const std::vector<double> &solution) const {
+		std::vector<double> values;
+
+		for (const auto &optimized : mParameters) {
+			scgms::IFilter_Parameter *parameter = Find_Parameter(configuration, optimized.filter_index, optimized.configuration_name.c_str());
+			if (!parameter) return E_INVALIDARG;
+
+			const size_t first = optimized.first_dimension, last = optimized.first_dimension + optimized.dimension_count;
+			values.clear();
+			values.insert(values.end(), mLower_Bound.begin() + first, mLower_Bound.begin() + last);
+			values.insert(values.end(), solution.begin() + first, solution.begin() + last);
+			values.insert(values.end(), mUpper_Bound.begin() + first, mUpper_Bound.begin() + last);
+
+			scgms::IModel_Parameter_Vector *container = refcnt::Create_Container<double>(values.data(), values.data() + values.size());
+			if (!container) return E_OUTOFMEMORY;
+
+			const HRESULT rc = parameter->Set_Model_Parameters(container);
+			container->Release();
+			if (rc != S_OK) return rc;
+		}
+
+		return S_OK;
+	}
+
+	double CParameters_Optimizer::Evaluate(const std::vector<double> &solution, refcnt::wstr_list *error_description) const {
+		constexpr double failed_metric = std::numeric_limits<double>::max();
+
+		refcnt::SReferenced<scgms::IFilter_Chain_Configuration> clone;
+		if ((Clone_Configuration(clone) != S_OK) || (Write_Solution(clone.get(), solution) != S_OK)) {
+			refcnt::Swstr_list shared_error_description = refcnt::make_shared_reference_ext<refcnt::Swstr_list, refcnt::wstr_list>(error_description, true);
+			shared_error_description.push(dsFailed_to_clone_configuration);
+			return failed_metric;
+		}
+
+#if defined(ESP32)
+		TCandidate_Evaluation evaluation{ mOn_Filter_Created, mOn_Filter_Created_Data, mOn_Filter_Created_Guard, failed_metric, false };
+#elif defined(FREERTOS) || defined(WASM)
+		TCandidate_Evaluation evaluation{ mOn_Filter_Created, mOn_Filter_Created_Data, failed_metric, false };
+#endif
+
+		//presentation-only filters only cost time, when evaluating the candidates
+		scgms::IFilter_Executor *executor = nullptr;
+		if (execute_filter_configuration_ex(clone.get(), scgms::NExecution_Flags::Elide_Presentation_Only, On_Candidate_Filter_Created, &evaluation, nullptr, &executor, error_description, nullptr) != S_OK)
+			return failed_metric;
+
+		//the replayed data end with the shut down event; once the chain is cleared, the promised metric gets written
+		executor->Terminate(TRUE);
+		executor->Release();
+
+		if (!evaluation.metric_promised || std::isnan(evaluation.metric))
+			return failed_metric;
+
+		return evaluation.metric;
+	}
+
+	HRESULT CParameters_Optimizer::Optimize(const size_t population_size, const size_t max_generations, solver::TSolver_Progress &progress, refcnt::Swstr_list &error_description) {
+		const size_t dimension_count = mDefault_Solution.size();
+
+		//evaluate the configured solution first and alone, so that the configuration errors get reported just once
+		const double default_metric = Evaluate(mDefault_Solution, error_description.get());
+		if (default_metric == std::numeric_limits<double>::max())
+			return E_FAIL;
+
+		std::mt19937_64 random_generator{ std::random_device{}() };
+		std::uniform_real_distribution<double> uniform_distribution{ 0.0, 1.0 };
+
+		const size_t effective_population_size = std::max(population_size, Minimal_Population_Size);
+		std::vector<std::vector<double>> population(effective_population_size, mDefault_Solution);
+		std::vector<double> fitness(effective_population_size, std::numeric_limits<double>::max());
+		fitness[0] = default_metric;
+
+		for (size_t i = 1; i < effective_population_size; i++)
+			for (size_t d = 0; d < dimension_count; d++)
+				population[i][d] = mLower_Bound[d] + uniform_distribution(random_generator) * (mUpper_Bound[d] - mLower_Bound[d]);
+
+		CWorker_Pool worker_pool;
+		worker_pool.Parallel_For(effective_population_size - 1, [&](const size_t index) {
+			fitness[index + 1] = Evaluate(population[index + 1], nullptr);
+		});
+
+		auto best_iter = std::min_element(fitness.begin(), fitness.end());
+		progress.max_progress = max_generations;
+		progress.best_metric[0] = *best_iter;
+
+		std::vector<std::vector<double>> trials(effective_population_size, mDefault_Solution);
+		std::vector<double> trial_fitness(effective_population_size);
+
+		for (size_t generation = 0; (generation < max_generations) && (progress.cancelled == FALSE); generation++) {
+			//rand/1/bin
+			for (size_t i = 0; i < effective_population_size; i++) {
+				size_t a, b, c;
+				do { a = random_generator() % effective_population_size; } while (a == i);
+				do { b = random_generator() % effective_population_size; } while ((b == i) || (b == a));
+				do { c = random_generator() % effective_population_size; } while ((c == i) || (c == a) || (c == b));
+
+				const size_t forced_dimension = random_generator() % dimension_count;
+				for (size_t d = 0; d < dimension_count; d++) {
+					if ((d == forced_dimension) || (uniform_distribution(random_generator) < Crossover_Probability)) {
+						const double mutated = population[a][d] + Differential_Weight * (population[b][d] - population[c][d]);
+						trials[i][d] = std::min(std::max(mutated, mLower_Bound[d]), mUpper_Bound[d]);
+					}
+					else
+						trials[i][d] = population[i][d];
+				}
+			}
+
+			worker_pool.Parallel_For(effective_population_size, [&](const size_t index) {
+				trial_fitness[index] = Evaluate(trials[index], nullptr);
+			});
+
+			for (size_t i = 0; i < effective_population_size; i++)
+				if (trial_fitness[i] <= fitness[i]) {
+					std::swap(population[i], trials[i]);
+					fitness[i] = trial_fitness[i];
+				}
+
+			best_iter = std::min_element(fitness.begin(), fitness.end());
+			progress.best_metric[0] = *best_iter;
+			progress.current_progress = generation + 1;
+		}
+
+		const std::vector<double> &best_solution = population[std::distance(fitness.begin(), best_iter)];
+		if (Write_Solution(mConfiguration, best_solution) != S_OK) {
+			error_description.push(dsFailed_to_write_parameters);
+			return E_FAIL;
+		}
+
+		return S_OK;
+	}
+}
+
+DLL_EXPORT HRESULT IfaceCalling optimize_parameters(scgms::IFilter_Chain_Configuration *configuration, const size_t filter_index, const wchar_t *parameters_configuration_name,
+	scgms::TOn_Filter_Created on_filter_created, const void* on_filter_created_data, const GUID *solver_id, const size_t population_size, const size_t max_generations,
+	solver::TSolver_Progress *progress, refcnt::wstr_list *error_description) {
+
+	return optimize_multiple_parameters(configuration, &filter_index, &parameters_configuration_name, 1, on_filter_created, on_filter_created_data,
+		solver_id, population_size, max_generations, progress, error_description);
+}
+
+DLL_EXPORT HRESULT IfaceCalling optimize_multiple_parameters(scgms::IFilter_Chain_Configuration *configuration, const size_t *filter_indices, const wchar_t **parameters_configuration_names, const size_t filter_count,
+	scgms::TOn_Filter_Created on_filter_created, const void* on_filter_created_data, const GUID *solver_id, const size_t population_size, const size_t max_generations,
+	solver::TSolver_Progress *progress, refcnt::wstr_list *error_description) {
+
+	if (!configuration || !filter_indices || !parameters_configuration_names || (filter_count == 0)) return E_INVALIDARG;
+
+	refcnt::Swstr_list shared_error_description = refcnt::make_shared_reference_ext<refcnt::Swstr_list, refcnt::wstr_list>(error_description, true);
+
+	solver::TSolver_Progress local_progress = solver::Null_Solver_Progress;
+	solver::TSolver_Progress &effective_progress = progress ? *progress : local_progress;
+
+	CParameters_Optimizer optimizer{ configuration, on_filter_created, on_filter_created_data };
+	HRESULT rc = optimizer.Read_Parameters(filter_indices, parameters_configuration_names, filter_count, shared_error_description);
+	if (rc != S_OK) return rc;
+
+	rc = optimizer.Optimize(population_size, max_generations, effective_progress, shared_error_description);
+	if (!Succeeded(rc))
+		shared_error_description.push(dsSolver_Failed);
+
+	return rc;
+}
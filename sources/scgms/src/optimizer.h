@@ -0,0 +1,53 @@
+/**
+ * SmartCGMS - continuous glucose monitoring and controlling framework
+ * https://diabetes.zcu.cz/
+ *
+ * Copyright (c) since 2018 University of West Bohemia.
+ *
+ * Contact:
+ * diabetes@mail.kiv.zcu.cz
+ * Medical Informatics, Department of Computer Science and Engineering
+ * Faculty of Applied Sciences, University of West Bohemia
+ * Univerzitni 8, 301 00 Pilsen
+ * Czech Republic
+ * 
+ * 
+ * Purpose of this software:
+ * This software is intended to demonstrate work of the diabetes.zcu.cz research
+ * group to other scientists, to complement our published papers. It is strictly
+ * prohibited to use this software for diagnosis or treatment of any medical condition,
+ * without obtaining all required approvals from respective regulatory bodies.
+ *
+ * Especially, a diabetic patient is warned that unauthorized use of this software
+ * may result into severe injure, including death.
+ *
+ *
+ * Licensing terms:
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * a) This file is available under the Apache License, Version 2.0.
+ * b) When publishing any derivative work or results obtained using this software, you agree to cite the following paper:
+ *    Tomas Koutny and Martin Ubl, "SmartCGMS as a Testbed for a Blood-Glucose Level Prediction and/or 
+ *    Control Challenge with (an FDA-Accepted) Diabetic Patient Simulation", Procedia Computer Science,  
+ *    Volume 177, pp. 354-362, 2020
+ */
+
+#pragma once
+
+#include <scgms/iface/FilterIface.h>
+#include <scgms/iface/SolverIface.h>
+
+//Local replacement of the desktop SmartCGMS optimizer. Each candidate solution is evaluated on its own clone
+//of the configuration, whose metric is obtained via ISignal_Error_Inspection::Promise_Metric, and the candidates
+//of each generation are evaluated concurrently. The search itself is a built-in differential evolution; solver_id is not used.
+//on_filter_created is called for the filters of every candidate, by the worker threads, but one call at a time.
+
+DLL_EXPORT HRESULT IfaceCalling optimize_parameters(scgms::IFilter_Chain_Configuration *configuration, const size_t filter_index, const wchar_t *parameters_configuration_name,
+	scgms::TOn_Filter_Created on_filter_created, const void* on_filter_created_data, const GUID *solver_id, const size_t population_size, const size_t max_generations,
+	solver::TSolver_Progress *progress, refcnt::wstr_list *error_description);
+
+DLL_EXPORT HRESULT IfaceCalling optimize_multiple_parameters(scgms::IFilter_Chain_Configuration *configuration, const size_t *filter_indices, const wchar_t **parameters_configuration_names, const size_t filter_count,
+	scgms::TOn_Filter_Created on_filter_created, const void* on_filter_created_data, const GUID *solver_id, const size_t population_size, const size_t max_generations,
+	solver::TSolver_Progress *progress, refcnt::wstr_list *error_description);
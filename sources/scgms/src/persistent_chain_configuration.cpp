@@ -36,6 +36,8 @@
 
 #include "persistent_chain_configuration.h"
 #include "configuration_link.h"
+#include "binary_chain_configuration.h"
+#include "startup_profiler.h"
 #if defined(EMBEDDED)
 #include <filters/generated/filters.h>
 #elif
@@ -47,101 +49,101 @@
 #include <scgms/rtl/rattime.h>
 #include <scgms/lang/dstrings.h>
 #include <scgms/utils/string_utils.h>
-#include <scgms/utils/SimpleIni.h>
+#include <scgms/utils/ini_view.h>
+#include <scgms/utils/heap_profiler.h>
 
 #include <exception>
+#include <algorithm>
 
 CPersistent_Chain_Configuration::CPersistent_Chain_Configuration() {
 	//
 }
 
 CPersistent_Chain_Configuration::~CPersistent_Chain_Configuration() noexcept {
-	//
+	//the links still hold the arena, until the container releases them
+	if (mArena)
+		mArena->Release();
+}
+
+CConfiguration_Arena* CPersistent_Chain_Configuration::Arena() noexcept {
+	if (!mArena)
+		mArena = CConfiguration_Arena::Create();	//nullptr just makes the objects go to the heap
+	return mArena;
 }
 
 
 HRESULT IfaceCalling CPersistent_Chain_Configuration::Load_From_Memory(const char* memory, const size_t len, refcnt::wstr_list* error_description) noexcept {
-	CSimpleIniW mIni;
+	CArena_Scope arena_scope{ Arena() };
+	SCGMS_HEAP_TAG(Config);
+	CIni_View ini;
 
 	refcnt::Swstr_list shared_error_description = refcnt::make_shared_reference_ext<refcnt::Swstr_list, refcnt::wstr_list>(error_description, true);
 
-	if (mIni.LoadData(memory, len) != SI_Error::SI_OK) {
+	bool parsed;
+	{
+		SCGMS_STARTUP_PHASE(Ini_Load);
+		parsed = ini.Parse(memory, len);
+	}
+
+	if (!parsed) {
 		shared_error_description.push(L"Could not load INI file from memory");
 		return E_FAIL;
 	}
 
 	bool loaded_all_filters = true;
-	bool encountered_E_NOT_SET = false;
 
-	std::list<CSimpleIniW::Entry> section_names;
-	mIni.GetAllSections(section_names);
+	auto& sections = ini.Sections();
 
 	// sort by section names - the name would contain zero-padded number, so it is possible to sort it as strings
-	section_names.sort([](auto& a, auto& b) {
-		return std::wstring(a.pItem).compare(b.pItem) < 0;
-		});
-
-	for (auto& section_name : section_names) {
-		std::wstring name_str{ section_name.pItem };
-		const std::wstring prefix{ rsFilter_Section_Prefix };
-		auto res = std::mismatch(prefix.begin(), prefix.end(), name_str.begin());
-		if (res.first == prefix.end()) {
-
-			auto uspos = name_str.find(rsFilter_Section_Separator, prefix.size() + 1);
-			if (uspos == std::wstring::npos)
+	{
+		SCGMS_STARTUP_PHASE(Section_Sort);
+		std::stable_sort(sections.begin(), sections.end(), [](auto& a, auto& b) {
+			return a.name < b.name;
+			});
+	}
+
+	const std::string prefix = Narrow_WChar(rsFilter_Section_Prefix);
+	const char separator = static_cast<char>(rsFilter_Section_Separator);
+
+	for (auto& section : sections) {
+		if ((section.name.size() >= prefix.size()) && (section.name.compare(0, prefix.size(), prefix) == 0)) {
+
+			auto uspos = section.name.find(separator, prefix.size() + 1);
+			if (uspos == std::string_view::npos)
 				uspos = prefix.size();
 
 			//OK, this is filter section - extract the guid
-			const std::wstring section_id_str { name_str.begin() + uspos + 1, name_str.end() };
+			const std::wstring section_id_str = Widen_UTF8(section.name.substr(std::min(uspos + 1, section.name.size())));
 			bool section_id_ok;
 			const GUID id = WString_To_GUID(section_id_str, section_id_ok);
 			//and get the filter descriptor to load the parameters
 
 			scgms::TFilter_Descriptor desc = scgms::Null_Filter_Descriptor;
+			bool desc_found;
+			{
+				SCGMS_STARTUP_PHASE(Descriptor_Resolution, id);
+				desc_found = section_id_ok && scgms::get_filter_descriptor_by_id(id, desc);
+			}
 
-				
-
-			if (section_id_ok && scgms::get_filter_descriptor_by_id(id, desc)) {
+			if (desc_found) {
 				refcnt::SReferenced<scgms::IFilter_Configuration_Link> filter_config{ new CFilter_Configuration_Link{id} };
 
 				//so.. now, try to load the filter parameters - aka filter_config
 				if (filter_config) {
+					SCGMS_STARTUP_PHASE(Parameter_Parsing, id);
 					for (size_t i = 0; i < desc.parameters_count; i++) {
 
 						//does the value exists?
-						const wchar_t* str_value = mIni.GetValue(section_name.pItem, desc.config_parameter_name[i]);
-						if (str_value) {
-
+						const std::string_view value = section.Find_Value(desc.config_parameter_name[i]);
+						if (value.data()) {
+							//the values get parsed once read - filters often do not read e.g., long parameter vectors at all
+							//malformed values are reported by Validate
 							std::unique_ptr<CFilter_Parameter> raw_filter_parameter = std::make_unique<CFilter_Parameter>(desc.parameter_type[i], desc.config_parameter_name[i]);
-							const HRESULT valid_rc = raw_filter_parameter->from_string(desc.parameter_type[i], str_value);							
-
-							if (Succeeded(valid_rc) || (valid_rc == E_NOT_SET)) {
-								scgms::IFilter_Parameter* raw_param = static_cast<scgms::IFilter_Parameter*>(raw_filter_parameter.get());								
-
-								if (Succeeded(filter_config->add(&raw_param, &raw_param + 1)))
-									raw_filter_parameter.release();
-
-								if (valid_rc == E_NOT_SET) {
-									encountered_E_NOT_SET = true;
-									std::wstring error_desc = dsVar_Not_Set_Filter_Parameter_Value;
-									error_desc.append(desc.description);
-									error_desc.append(L" (2)");
-									error_desc.append(desc.ui_parameter_name[i]);
-									error_desc.append(L" (3)");
-									error_desc.append(str_value);
-									shared_error_description.push(error_desc.c_str());
-								}
-							}
-							else {
-								std::wstring error_desc = dsMalformed_Filter_Parameter_Value;
-								error_desc.append(desc.description);
-								error_desc.append(L" (2)");
-								error_desc.append(desc.ui_parameter_name[i]);
-								error_desc.append(L" (3)");
-								error_desc.append(str_value);
-								shared_error_description.push(error_desc.c_str());
-							}
+							raw_filter_parameter->Defer_Parsing(value);
 
+							scgms::IFilter_Parameter* raw_param = static_cast<scgms::IFilter_Parameter*>(raw_filter_parameter.get());
+							if (Succeeded(filter_config->add(&raw_param, &raw_param + 1)))
+								raw_filter_parameter.release();
 						}
 						else if (desc.parameter_type[i] != scgms::NParameter_Type::ptNull) {
 							//this parameter is not configured, warn about it
@@ -173,7 +175,7 @@ HRESULT IfaceCalling CPersistent_Chain_Configuration::Load_From_Memory(const cha
 			}
 		}
 		else {
-			std::wstring error_desc = dsInvalid_Section_Name + name_str;
+			std::wstring error_desc = dsInvalid_Section_Name + Widen_UTF8(section.name);
 			shared_error_description.push(error_desc.c_str());
 		}
 
@@ -182,13 +184,252 @@ HRESULT IfaceCalling CPersistent_Chain_Configuration::Load_From_Memory(const cha
 	if (!loaded_all_filters)
 		describe_loaded_filters(shared_error_description);
 
-	return (loaded_all_filters || encountered_E_NOT_SET) ? S_OK : S_FALSE;
+	return loaded_all_filters ? S_OK : S_FALSE;
+}
+
+
+HRESULT IfaceCalling CPersistent_Chain_Configuration::Validate(refcnt::wstr_list* error_description) noexcept {
+	refcnt::Swstr_list shared_error_description = refcnt::make_shared_reference_ext<refcnt::Swstr_list, refcnt::wstr_list>(error_description, true);
+
+	bool all_valid = true;
+
+	for (scgms::IFilter_Configuration_Link* link : mData) {
+		scgms::IFilter_Parameter **param_begin, **param_end;
+		if (link->get(&param_begin, &param_end) != S_OK)
+			continue;
+
+		for (auto param_iter = param_begin; param_iter != param_end; param_iter++) {
+			if ((*param_iter)->Validate() == S_OK)
+				continue;
+
+			all_valid = false;
+
+			GUID id = Invalid_GUID;
+			link->Get_Filter_Id(&id);
+			scgms::TFilter_Descriptor desc = scgms::Null_Filter_Descriptor;
+			scgms::get_filter_descriptor_by_id(id, desc);
+
+			wchar_t* config_name = nullptr;
+			(*param_iter)->Get_Config_Name(&config_name);
+			const wchar_t* ui_name = config_name;
+			for (size_t i = 0; i < desc.parameters_count; i++)
+				if (config_name && (wcscmp(desc.config_parameter_name[i], config_name) == 0)) {
+					ui_name = desc.ui_parameter_name[i];
+					break;
+				}
+
+			HRESULT rc;
+			scgms::SFilter_Parameter parameter = refcnt::make_shared_reference_ext<scgms::SFilter_Parameter, scgms::IFilter_Parameter>(*param_iter, true);
+
+			std::wstring error_desc = dsMalformed_Filter_Parameter_Value;
+			error_desc.append(desc.description ? desc.description : GUID_To_WString(id).c_str());
+			error_desc.append(L" (2)");
+			error_desc.append(ui_name ? ui_name : L"");
+			error_desc.append(L" (3)");
+			error_desc.append(parameter.as_wstring(rc, false));
+			shared_error_description.push(error_desc.c_str());
+		}
+	}
+
+	return all_valid ? S_OK : S_FALSE;
+}
+
+
+namespace {
+	//returns nullptr, if the precompiled record does not match the filter descriptor anymore
+	std::unique_ptr<CFilter_Parameter> Make_Precompiled_Parameter(const scgms::TFilter_Descriptor& desc, const size_t desc_idx, const scgms::NParameter_Type type, refcnt::Swstr_list& error_description) {
+		if ((desc_idx < desc.parameters_count) && (desc.parameter_type[desc_idx] == type))
+			return std::make_unique<CFilter_Parameter>(type, desc.config_parameter_name[desc_idx]);
+
+		std::wstring error_desc = dsBinary_Chain_Parameter_Mismatch;
+		error_desc.append(desc.description);
+		error_desc.append(L" (2)");
+		error_desc.append(std::to_wstring(desc_idx));
+		error_description.push(error_desc.c_str());
+		return nullptr;
+	}
+
+	void Add_Precompiled_Parameter(scgms::IFilter_Configuration_Link* link, std::unique_ptr<CFilter_Parameter> parameter, const HRESULT valid_rc, const scgms::TFilter_Descriptor& desc, const size_t desc_idx, refcnt::Swstr_list& error_description) {
+		if (valid_rc == S_OK) {
+			scgms::IFilter_Parameter* raw_param = static_cast<scgms::IFilter_Parameter*>(parameter.get());
+			if (Succeeded(link->add(&raw_param, &raw_param + 1)))
+				parameter.release();
+		}
+		else {
+			std::wstring error_desc = dsMalformed_Filter_Parameter_Value;
+			error_desc.append(desc.description);
+			error_desc.append(L" (2)");
+			error_desc.append(desc.ui_parameter_name[desc_idx]);
+			error_desc.append(L" (3)");
+			error_description.push(error_desc.c_str());
+		}
+	}
+}
+
+HRESULT IfaceCalling CPersistent_Chain_Configuration::Load_From_Binary(const uint8_t* binary, const size_t len, refcnt::wstr_list* error_description) noexcept {
+	CArena_Scope arena_scope{ Arena() };
+	SCGMS_HEAP_TAG(Config);
+	refcnt::Swstr_list shared_error_description = refcnt::make_shared_reference_ext<refcnt::Swstr_list, refcnt::wstr_list>(error_description, true);
+
+	auto report_malformed = [&shared_error_description](const size_t offset) {
+		const std::wstring error_desc = dsMalformed_Binary_Chain_Configuration + std::to_wstring(offset);
+		shared_error_description.push(error_desc.c_str());
+		return E_FAIL;
+	};
+
+	if (!binary)
+		return E_INVALIDARG;
+
+	binary_chain::CReader reader{ binary, len };
+	binary_chain::THeader header;
+	if (!binary_chain::Read_Header(reader, header))
+		return report_malformed(0);
+
+	bool loaded_all_filters = true;
+	uint64_t filters_hash = binary_chain::Hash_Basis;
+
+	try {
+		for (uint32_t link_idx = 0; link_idx < header.link_count; link_idx++) {
+			const GUID id = reader.Read_GUID();
+			const uint16_t parameter_count = reader.Read_U16();
+			if (!reader.Valid())
+				return report_malformed(reader.Offset());
+
+			scgms::TFilter_Descriptor desc = scgms::Null_Filter_Descriptor;
+			const bool desc_found = scgms::get_filter_descriptor_by_id(id, desc);
+			if (desc_found)
+				filters_hash = binary_chain::Hash_Descriptor(desc, filters_hash);
+			else {
+				loaded_all_filters = false;
+				std::wstring error_desc = dsCannot_Resolve_Filter_Descriptor + GUID_To_WString(id);
+				shared_error_description.push(error_desc.c_str());
+			}
+
+			refcnt::SReferenced<scgms::IFilter_Configuration_Link> filter_config;
+			if (desc_found) {
+				filter_config = refcnt::SReferenced<scgms::IFilter_Configuration_Link>{ new CFilter_Configuration_Link{id} };
+				if (!filter_config) {
+					shared_error_description.push(rsFailed_to_allocate_memory);
+					return E_FAIL;
+				}
+			}
+
+			//the records of an unresolved filter are still read, just to skip them
+			for (uint16_t param_idx = 0; param_idx < parameter_count; param_idx++) {
+				const size_t desc_idx = reader.Read_U16();
+				const scgms::NParameter_Type type = static_cast<scgms::NParameter_Type>(reader.Read_U8());
+				const binary_chain::NValue_Encoding encoding = static_cast<binary_chain::NValue_Encoding>(reader.Read_U8());
+				if (!reader.Valid())
+					return report_malformed(reader.Offset());
+
+				//on a descriptor mismatch, the record layout is still valid, so we just skip it
+				std::unique_ptr<CFilter_Parameter> raw_filter_parameter;
+				if (desc_found)
+					raw_filter_parameter = Make_Precompiled_Parameter(desc, desc_idx, type, shared_error_description);
+
+				const HRESULT valid_rc = binary_chain::Read_Parameter_Value(reader, type, encoding, raw_filter_parameter.get());
+				if (!reader.Valid())
+					return report_malformed(reader.Offset());
+
+				if (raw_filter_parameter)
+					Add_Precompiled_Parameter(filter_config.get(), std::move(raw_filter_parameter), valid_rc, desc, desc_idx, shared_error_description);
+			}
+
+			if (filter_config) {
+				auto raw_filter_config = filter_config.get();
+				add(&raw_filter_config, &raw_filter_config + 1);
+			}
+		}
+	}
+	catch (...) {
+		shared_error_description.push(rsFailed_to_allocate_memory);
+		return E_FAIL;
+	}
+
+	if (!reader.At_End())
+		return report_malformed(reader.Offset());
+
+	//the same types at the same indices do not mean the same parameters
+	if (loaded_all_filters && (filters_hash != header.filters_hash)) {
+		shared_error_description.push(dsBinary_Chain_Filters_Mismatch);
+		return E_FAIL;
+	}
+
+	if (!loaded_all_filters)
+		describe_loaded_filters(shared_error_description);
+
+	return loaded_all_filters ? S_OK : S_FALSE;
+}
+
+
+HRESULT IfaceCalling CPersistent_Chain_Configuration::Load_From_Tables(const scgms::TChain_Table* table, refcnt::wstr_list* error_description) noexcept {
+	if (!table || (!table->links && (table->links_count > 0)))
+		return E_INVALIDARG;
+
+	CArena_Scope arena_scope{ Arena() };
+	SCGMS_HEAP_TAG(Config);
+
+	refcnt::Swstr_list shared_error_description = refcnt::make_shared_reference_ext<refcnt::Swstr_list, refcnt::wstr_list>(error_description, true);
+
+	bool loaded_all_filters = true;
+
+	try {
+		for (size_t link_idx = 0; link_idx < table->links_count; link_idx++) {
+			const scgms::TLink_Entry& link = table->links[link_idx];
+
+			scgms::TFilter_Descriptor desc = scgms::Null_Filter_Descriptor;
+			if (!scgms::get_filter_descriptor_by_id(link.filter_id, desc)) {
+				loaded_all_filters = false;
+				std::wstring error_desc = dsCannot_Resolve_Filter_Descriptor + GUID_To_WString(link.filter_id);
+				shared_error_description.push(error_desc.c_str());
+				continue;
+			}
+
+			refcnt::SReferenced<scgms::IFilter_Configuration_Link> filter_config{ new CFilter_Configuration_Link{link.filter_id} };
+			if (!filter_config) {
+				shared_error_description.push(rsFailed_to_allocate_memory);
+				return E_FAIL;
+			}
+
+			for (size_t param_idx = 0; param_idx < link.parameters_count; param_idx++) {
+				const scgms::TParameter_Entry& entry = link.parameters[param_idx];
+
+				std::unique_ptr<CFilter_Parameter> raw_filter_parameter = Make_Precompiled_Parameter(desc, entry.descriptor_index, entry.type, shared_error_description);
+				if (raw_filter_parameter) {
+					const HRESULT valid_rc = binary_chain::Set_Parameter_Value(entry, raw_filter_parameter.get());
+					Add_Precompiled_Parameter(filter_config.get(), std::move(raw_filter_parameter), valid_rc, desc, entry.descriptor_index, shared_error_description);
+				}
+			}
+
+			auto raw_filter_config = filter_config.get();
+			add(&raw_filter_config, &raw_filter_config + 1);
+		}
+	}
+	catch (...) {
+		shared_error_description.push(rsFailed_to_allocate_memory);
+		return E_FAIL;
+	}
+
+	if (!loaded_all_filters)
+		describe_loaded_filters(shared_error_description);
+
+	return loaded_all_filters ? S_OK : S_FALSE;
 }
 
 
 HRESULT IfaceCalling CPersistent_Chain_Configuration::add(scgms::IFilter_Configuration_Link** begin, scgms::IFilter_Configuration_Link** end) noexcept {
 	HRESULT rc = refcnt::internal::CVector_Container<scgms::IFilter_Configuration_Link*>::add(begin, end);
 
+	if (Succeeded(rc)) {
+		for (auto link = begin; link != end; link++) {
+			CFilter_Configuration_Link* configuration_link = dynamic_cast<CFilter_Configuration_Link*>(*link);
+			if (configuration_link) {
+				configuration_link->Bind_Variables(mVariables);
+				configuration_link->Index_Parameters();
+			}
+		}
+	}
+
 	return rc;	
 }
 
@@ -198,17 +439,37 @@ HRESULT IfaceCalling CPersistent_Chain_Configuration::Set_Variable(const wchar_t
 	if (!name || (*name == 0)) return E_INVALIDARG;
 	if (name == CFilter_Parameter::mUnused_Variable_Name) return TYPE_E_AMBIGUOUSNAME;
 
-	HRESULT rc = refcnt::internal::CVector_Container<scgms::IFilter_Configuration_Link*>::empty();
-	if (rc == S_FALSE) {
-		for (scgms::IFilter_Configuration_Link* link : mData) {
-			if (!Succeeded(link->Set_Variable(name, value)))
-				rc = E_UNEXPECTED;
-		}
+	HRESULT rc = mVariables->Set(name, value);
+	if (!Succeeded(rc))
+		return rc;
+
+	//links of other origin than ours do not know the table
+	for (scgms::IFilter_Configuration_Link* link : mData) {
+		if (!dynamic_cast<CFilter_Configuration_Link*>(link) && !Succeeded(link->Set_Variable(name, value)))
+			rc = E_UNEXPECTED;
 	}
 
 	return rc;
 }
 
+HRESULT CPersistent_Chain_Configuration::Copy_Variables(const CPersistent_Chain_Configuration &other) noexcept {
+	if (&other == this)
+		return S_FALSE;
+
+	try {
+		HRESULT rc = S_OK;
+		for (const auto &variable : other.mVariables->Get_All()) {
+			if (!Succeeded(Set_Variable(std::get<0>(variable).c_str(), std::get<1>(variable).c_str())))
+				rc = E_UNEXPECTED;
+		}
+
+		return rc;
+	}
+	catch (...) {
+		return E_OUTOFMEMORY;
+	}
+}
+
 HRESULT IfaceCalling create_persistent_filter_chain_configuration(scgms::IPersistent_Filter_Chain_Configuration** configuration) noexcept {
 	return Manufacture_Object<CPersistent_Chain_Configuration, scgms::IPersistent_Filter_Chain_Configuration>(configuration);
 }
@@ -38,6 +38,11 @@
 
 #include <scgms/iface/FilterIface.h>
 #include <scgms/rtl/referencedImpl.h>
+
+#include "variable_table.h"
+#include "configuration_arena.h"
+
+#include <memory>
 //#include <scgms/rtl/UILib.h>
 
 
@@ -49,6 +54,13 @@ protected:
 	//filesystem::path mFile_Path;
 	//std::wstring Get_Parent_Path() noexcept;
 	//void Advertise_Parent_Path() noexcept;
+protected:
+	//Set_Variable goes here, instead of to every parameter of every link
+	std::shared_ptr<CVariable_Table> mVariables = std::make_shared<CVariable_Table>();
+protected:
+	//the links and the parameters are loaded into the arena
+	CConfiguration_Arena* mArena = nullptr;
+	CConfiguration_Arena* Arena() noexcept;
 protected:
 	//wchar_t* Describe_GUID(const GUID& val, const scgms::NParameter_Type param_type, const scgms::CSignal_Description& signal_descriptors) const noexcept;	
 public:
@@ -60,9 +72,13 @@ public:
 	//virtual HRESULT IfaceCalling Get_Parent_Path(refcnt::wstr_container** path) noexcept override final;
 	//virtual HRESULT IfaceCalling Set_Parent_Path(const wchar_t* parent_path) noexcept override final;
 	virtual HRESULT IfaceCalling Set_Variable(const wchar_t* name, const wchar_t* value) noexcept override final;
+	HRESULT Copy_Variables(const CPersistent_Chain_Configuration &other) noexcept;	//a clone of the links has its own table, so it needs the other's values
 
 	//virtual HRESULT IfaceCalling Load_From_File(const wchar_t *file_path, refcnt::wstr_list *error_description) noexcept override final;
 	virtual HRESULT IfaceCalling Load_From_Memory(const char *memory, const size_t len, refcnt::wstr_list *error_description) noexcept override final;
+	virtual HRESULT IfaceCalling Load_From_Binary(const uint8_t *binary, const size_t len, refcnt::wstr_list *error_description) noexcept override final;
+	virtual HRESULT IfaceCalling Load_From_Tables(const scgms::TChain_Table *table, refcnt::wstr_list *error_description) noexcept override final;
+	virtual HRESULT IfaceCalling Validate(refcnt::wstr_list *error_description) noexcept override final;
 	//virtual HRESULT IfaceCalling Save_To_File(const wchar_t *file_path, refcnt::wstr_list* error_description) noexcept override final;	
 };
 
@@ -0,0 +1,286 @@
+/**
+ * SmartCGMS - continuous glucose monitoring and controlling framework
+ * https://diabetes.zcu.cz/
+ *
+ * Copyright (c) since 2018 University of West Bohemia.
+ *
+ * Contact:
+ * diabetes@mail.kiv.zcu.cz
+ * Medical Informatics, Department of Computer Science and Engineering
+ * Faculty of Applied Sciences, University of West Bohemia
+ * Univerzitni 8, 301 00 Pilsen
+ * Czech Republic
+ * 
+ * 
+ * Purpose of this software:
+ * This software is intended to demonstrate work of the diabetes.zcu.cz research
+ * group to other scientists, to complement our published papers. It is strictly
+ * prohibited to use this software for diagnosis or treatment of any medical condition,
+ * without obtaining all required approvals from respective regulatory bodies.
+ *
+ * Especially, a diabetic patient is warned that unauthorized use of this software
+ * may result into severe injure, including death.
+ *
+ *
+ * Licensing terms:
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * a) This file is available under the Apache License, Version 2.0.
+ * b) When publishing any derivative work or results obtained using this software, you agree to cite the following paper:
+ *    Tomas Koutny and Martin Ubl, "SmartCGMS as a Testbed for a Blood-Glucose Level Prediction and/or 
+ *    Control Challenge with (an FDA-Accepted) Diabetic Patient Simulation", Procedia Computer Science,  
+ *    Volume 177, pp. 354-362, 2020
+ */
+
+#include "sharded_executor.h"
+#include "filter_configuration_executor.h"
+
+#include <scgms/rtl/FilterLib.h>
+#include <scgms/rtl/DeviceLib.h>
+#include <scgms/lang/dstrings.h>
+
+namespace {
+	size_t Segment_Shard(const uint64_t segment_id, const size_t shard_count) {
+		//segment ids are mostly consecutive small numbers, so we mix them first (splitmix64 finalizer)
+		uint64_t x = segment_id;
+		x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+		x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+		x = x ^ (x >> 31);
+		return static_cast<size_t>(x % shard_count);
+	}
+}
+
+CShard_Output::CShard_Output(CSharded_Filter_Executor &owner) : mOwner(owner) {
+	//
+}
+
+HRESULT IfaceCalling CShard_Output::Configure(scgms::IFilter_Configuration* configuration, refcnt::wstr_list* error_description) {
+	return S_OK;
+}
+
+HRESULT IfaceCalling CShard_Output::Execute(scgms::IDevice_Event *event) {
+	if (!event) return E_INVALIDARG;
+	return mOwner.Output(event);
+}
+
+
+CSharded_Filter_Executor::CSharded_Filter_Executor(scgms::IFilter *custom_output) : mCustom_Output(custom_output) {
+	//
+}
+
+CSharded_Filter_Executor::~CSharded_Filter_Executor() {
+	Terminate(FALSE);
+
+	//the shards' chains reference the outputs, so they must go first
+	for (auto &shard : mShards)
+		if (shard->executor) shard->executor->Release();
+	mShards.clear();
+}
+
+HRESULT CSharded_Filter_Executor::Build_Shards(scgms::IFilter_Chain_Configuration *configuration, const size_t shard_count, const scgms::NExecution_Flags execution_flags, scgms::TOn_Filter_Created on_filter_created, const void* on_filter_created_data, refcnt::Swstr_list& error_description, refcnt::wstr_list *elided_filters) {
+	if (!mShards.empty()) return E_ILLEGAL_METHOD_CALL;
+
+	size_t effective_count = shard_count;
+#if defined(ESP32)
+	if (effective_count == 0) effective_count = static_cast<size_t>(std::thread::hardware_concurrency());
+#endif
+	if (effective_count == 0) effective_count = 1;
+
+	for (size_t i = 0; i < effective_count; i++) {
+		std::unique_ptr<TShard> shard = std::make_unique<TShard>();
+		shard->output = std::make_unique<CShard_Output>(*this);
+
+		//all the shards share the same configuration, so that it is enough to describe the first one
+		const bool is_first = i == 0;
+		const HRESULT rc = execute_filter_configuration_ex(configuration, execution_flags, on_filter_created, on_filter_created_data, shard->output.get(), &shard->executor,
+			is_first ? error_description.get() : nullptr, is_first ? elided_filters : nullptr);
+		if (!Succeeded(rc)) {
+			if (!is_first)
+				error_description.push(dsFailed_to_build_shard + std::to_wstring(i));
+			return rc;
+		}
+
+		mShards.push_back(std::move(shard));
+	}
+
+#if defined(ESP32) && !defined(SCGMS_SINGLE_THREADED_REFCNT)
+	for (auto &shard : mShards)
+		shard->worker = std::thread{ &CSharded_Filter_Executor::Shard_Loop, this, std::ref(*shard) };
+#endif
+
+	return S_OK;
+}
+
+HRESULT CSharded_Filter_Executor::Output(scgms::IDevice_Event *event) {
+#if defined(ESP32)
+	std::lock_guard<std::mutex> guard{ mOutput_Guard };
+#endif
+
+	scgms::TDevice_Event *raw_event;
+	if (event->Raw(&raw_event) == S_OK) {
+		const bool is_clone = !mBroadcast_Clones.empty() && (mBroadcast_Clones.erase(raw_event->logical_time) > 0);
+
+		if (raw_event->event_code == scgms::NDevice_Event_Code::Shut_Down) {
+			//the last one, so that all the shards have finished
+			mShut_Down_Count++;
+			if (mShut_Down_Count < mShards.size()) {
+				event->Release();
+				return S_OK;
+			}
+
+			mBroadcast_Clones.clear();	//those consumed by the filters
+		}
+		else if (is_clone) {
+			event->Release();
+			return S_OK;
+		}
+	}
+
+	if (mCustom_Output)
+		return mCustom_Output->Execute(event);
+
+	event->Release();
+	return S_OK;
+}
+
+#if defined(ESP32)
+void CSharded_Filter_Executor::Shard_Loop(TShard &shard) {
+	std::unique_lock<std::mutex> lock{ shard.guard };
+	while (true) {
+		shard.event_available.wait(lock, [&shard]() { return shard.terminating || !shard.queue.empty(); });
+		if (shard.queue.empty())
+			return;		//terminating and drained
+
+		scgms::IDevice_Event *event = shard.queue.front();
+		shard.queue.pop_front();
+
+		lock.unlock();
+		shard.executor->Execute(event);
+		lock.lock();
+	}
+}
+#endif
+
+HRESULT CSharded_Filter_Executor::Enqueue(TShard &shard, scgms::IDevice_Event *event) {
+#if defined(ESP32) && !defined(SCGMS_SINGLE_THREADED_REFCNT)
+	{
+		std::lock_guard<std::mutex> lock{ shard.guard };
+		shard.queue.push_back(event);
+	}
+	shard.event_available.notify_one();
+	return S_OK;
+#elif defined(FREERTOS) || defined(ESP32) || defined(WASM)
+	return shard.executor->Execute(event);
+#endif
+}
+
+HRESULT IfaceCalling CSharded_Filter_Executor::Execute(scgms::IDevice_Event *event) {
+	if (!event) return E_INVALIDARG;
+
+#if defined(ESP32)
+	std::lock_guard<std::mutex> guard{ mExecute_Guard };
+#endif
+	if (mTerminated || mShards.empty()) {
+		event->Release();
+		return E_ILLEGAL_METHOD_CALL;
+	}
+
+	scgms::TDevice_Event *raw_event;
+	HRESULT rc = event->Raw(&raw_event);
+	if (rc != S_OK) {
+		event->Release();
+		return rc;
+	}
+
+	if ((raw_event->segment_id != scgms::All_Segments_Id) && (raw_event->segment_id != scgms::Invalid_Segment_Id))
+		return Enqueue(*mShards[Segment_Shard(raw_event->segment_id, mShards.size())], event);
+
+	if (scgms::UDevice_Event_internal::major_type(raw_event->event_code) != scgms::UDevice_Event_internal::NDevice_Event_Major_Type::control)
+		return Enqueue(*mShards[0], event);
+
+	//broadcast - the original goes to the first shard, the others get clones, which the output drops then
+	for (size_t i = 1; i < mShards.size(); i++) {
+		scgms::IDevice_Event *clone = nullptr;
+		HRESULT clone_rc = event->Clone(&clone);
+		if (clone_rc == S_OK) {
+			scgms::TDevice_Event *raw_clone;
+			clone_rc = clone->Raw(&raw_clone);
+			if (clone_rc == S_OK) {
+#if defined(ESP32)
+				std::lock_guard<std::mutex> output_guard{ mOutput_Guard };
+#endif
+				mBroadcast_Clones.insert(raw_clone->logical_time);
+			}
+			Enqueue(*mShards[i], clone);
+		}
+
+		if (clone_rc != S_OK)
+			rc = clone_rc;
+	}
+
+	const HRESULT first_rc = Enqueue(*mShards[0], event);
+	return rc == S_OK ? first_rc : rc;
+}
+
+void CSharded_Filter_Executor::Stop_Shards(const bool drain) {
+#if defined(ESP32)
+	for (auto &shard : mShards) {
+		{
+			std::lock_guard<std::mutex> lock{ shard->guard };
+			shard->terminating = true;
+			if (!drain) {
+				for (auto event : shard->queue)
+					event->Release();
+				shard->queue.clear();
+			}
+		}
+		shard->event_available.notify_all();
+	}
+
+	for (auto &shard : mShards)
+		if (shard->worker.joinable())
+			shard->worker.join();
+#endif
+}
+
+HRESULT IfaceCalling CSharded_Filter_Executor::Terminate(const BOOL wait_for_shutdown) {
+	{
+#if defined(ESP32)
+		std::lock_guard<std::mutex> guard{ mExecute_Guard };
+#endif
+		if (mTerminated) return S_FALSE;
+		mTerminated = true;
+	}
+
+	//when waiting, the shards first process everything they have been already given
+	Stop_Shards(wait_for_shutdown == TRUE);
+
+	HRESULT rc = S_OK;
+	for (auto &shard : mShards) {
+		const HRESULT shard_rc = shard->executor->Terminate(wait_for_shutdown);
+		if (!Succeeded(shard_rc))
+			rc = shard_rc;
+	}
+
+	return rc;
+}
+
+DLL_EXPORT HRESULT IfaceCalling execute_sharded_filter_configuration(scgms::IFilter_Chain_Configuration *configuration, const size_t shard_count, const scgms::NExecution_Flags execution_flags, scgms::TOn_Filter_Created on_filter_created, const void* on_filter_created_data, scgms::IFilter *custom_output, scgms::IFilter_Executor **executor, refcnt::wstr_list *error_description, refcnt::wstr_list *elided_filters) {
+	std::unique_ptr<CSharded_Filter_Executor> raw_executor = std::make_unique<CSharded_Filter_Executor>(custom_output);
+	*executor = static_cast<scgms::IFilter_Executor*>(raw_executor.get());
+	(*executor)->AddRef();
+
+	refcnt::Swstr_list shared_error_description = refcnt::make_shared_reference_ext<refcnt::Swstr_list, refcnt::wstr_list>(error_description, true);
+
+	HRESULT rc = raw_executor->Build_Shards(configuration, shard_count, execution_flags, on_filter_created, on_filter_created_data, shared_error_description, elided_filters);
+	raw_executor.release();
+
+	if (!Succeeded(rc)) {
+		(*executor)->Release();
+		return rc;
+	}
+
+	return S_OK;
+}
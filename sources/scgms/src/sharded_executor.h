@@ -0,0 +1,119 @@
+/**
+ * SmartCGMS - continuous glucose monitoring and controlling framework
+ * https://diabetes.zcu.cz/
+ *
+ * Copyright (c) since 2018 University of West Bohemia.
+ *
+ * Contact:
+ * diabetes@mail.kiv.zcu.cz
+ * Medical Informatics, Department of Computer Science and Engineering
+ * Faculty of Applied Sciences, University of West Bohemia
+ * Univerzitni 8, 301 00 Pilsen
+ * Czech Republic
+ * 
+ * 
+ * Purpose of this software:
+ * This software is intended to demonstrate work of the diabetes.zcu.cz research
+ * group to other scientists, to complement our published papers. It is strictly
+ * prohibited to use this software for diagnosis or treatment of any medical condition,
+ * without obtaining all required approvals from respective regulatory bodies.
+ *
+ * Especially, a diabetic patient is warned that unauthorized use of this software
+ * may result into severe injure, including death.
+ *
+ *
+ * Licensing terms:
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * a) This file is available under the Apache License, Version 2.0.
+ * b) When publishing any derivative work or results obtained using this software, you agree to cite the following paper:
+ *    Tomas Koutny and Martin Ubl, "SmartCGMS as a Testbed for a Blood-Glucose Level Prediction and/or 
+ *    Control Challenge with (an FDA-Accepted) Diabetic Patient Simulation", Procedia Computer Science,  
+ *    Volume 177, pp. 354-362, 2020
+ */
+
+#pragma once
+
+#include <scgms/iface/FilterIface.h>
+#include <scgms/rtl/referencedImpl.h>
+
+#include <vector>
+#include <memory>
+#include <set>
+
+#if defined(ESP32)
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#endif
+
+#pragma warning( push )
+#pragma warning( disable : 4250 ) // C4250 - 'class1' : inherits 'class2::member' via dominance 
+
+class CSharded_Filter_Executor;
+
+//Output of a single shard; serializes the shards' output into the one custom output.
+class CShard_Output : public virtual scgms::IFilter, public virtual refcnt::CNotReferenced {
+protected:
+	CSharded_Filter_Executor &mOwner;
+public:
+	CShard_Output(CSharded_Filter_Executor &owner);
+	virtual ~CShard_Output() = default;
+
+	virtual HRESULT IfaceCalling Configure(scgms::IFilter_Configuration* configuration, refcnt::wstr_list* error_description) override final;
+	virtual HRESULT IfaceCalling Execute(scgms::IDevice_Event *event) override final;
+};
+
+//Instantiates the filter chain once per shard and routes each event by its segment id,
+//so that different segments can be processed in parallel, while the events of a single segment
+//keep their order. Control events of All_Segments_Id and Invalid_Segment_Id are broadcast to all shards, but leave
+//the executor just once; the other events of these segment ids go to the first shard.
+//Shards run in their own threads on ESP32; on FREERTOS and WASM, and with SCGMS_SINGLE_THREADED_REFCNT, the events are executed inline.
+class CSharded_Filter_Executor : public virtual scgms::IFilter_Executor, public virtual refcnt::CReferenced {
+protected:
+	struct TShard {
+		scgms::IFilter_Executor *executor = nullptr;
+		std::unique_ptr<CShard_Output> output;
+#if defined(ESP32)
+		std::deque<scgms::IDevice_Event*> queue;
+		std::mutex guard;
+		std::condition_variable event_available;
+		bool terminating = false;
+		std::thread worker;
+#endif
+	};
+
+	std::vector<std::unique_ptr<TShard>> mShards;
+	bool mTerminated = false;
+
+	friend class CShard_Output;
+	scgms::IFilter *mCustom_Output = nullptr;
+	size_t mShut_Down_Count = 0;		//shut down is broadcast, so that we forward just the last one
+	std::set<int64_t> mBroadcast_Clones;	//logical times of the broadcast clones, which are not forwarded
+#if defined(ESP32)
+	std::mutex mOutput_Guard;
+	std::mutex mExecute_Guard;
+
+	void Shard_Loop(TShard &shard);
+#endif
+
+	HRESULT Output(scgms::IDevice_Event *event);
+	HRESULT Enqueue(TShard &shard, scgms::IDevice_Event *event);
+	void Stop_Shards(const bool drain);
+public:
+	CSharded_Filter_Executor(scgms::IFilter *custom_output);
+	virtual ~CSharded_Filter_Executor();
+
+	HRESULT Build_Shards(scgms::IFilter_Chain_Configuration *configuration, const size_t shard_count, const scgms::NExecution_Flags execution_flags, scgms::TOn_Filter_Created on_filter_created, const void* on_filter_created_data, refcnt::Swstr_list& error_description, refcnt::wstr_list *elided_filters);
+
+	virtual HRESULT IfaceCalling Execute(scgms::IDevice_Event *event) override final;
+	virtual HRESULT IfaceCalling Terminate(const BOOL wait_for_shutdown) override final;
+};
+
+#pragma warning( pop )
+
+//shard_count == 0 selects the hardware concurrency; on_filter_created is called for every filter of every shard
+DLL_EXPORT HRESULT IfaceCalling execute_sharded_filter_configuration(scgms::IFilter_Chain_Configuration *configuration, const size_t shard_count, const scgms::NExecution_Flags execution_flags, scgms::TOn_Filter_Created on_filter_created, const void* on_filter_created_data, scgms::IFilter *custom_output, scgms::IFilter_Executor **executor, refcnt::wstr_list *error_description, refcnt::wstr_list *elided_filters);
@@ -0,0 +1,160 @@
+/**
+ * SmartCGMS - continuous glucose monitoring and controlling framework
+ * https://diabetes.zcu.cz/
+ *
+ * Copyright (c) since 2018 University of West Bohemia.
+ *
+ * Contact:
+ * diabetes@mail.kiv.zcu.cz
+ * Medical Informatics, Department of Computer Science and Engineering
+ * Faculty of Applied Sciences, University of West Bohemia
+ * Univerzitni 8, 301 00 Pilsen
+ * Czech Republic
+ * 
+ * 
+ * Purpose of this software:
+ * This software is intended to demonstrate work of the diabetes.zcu.cz research
+ * group to other scientists, to complement our published papers. It is strictly
+ * prohibited to use this software for diagnosis or treatment of any medical condition,
+ * without obtaining all required approvals from respective regulatory bodies.
+ *
+ * Especially, a diabetic patient is warned that unauthorized use of this software
+ * may result into severe injure, including death.
+ *
+ *
+ * Licensing terms:
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * a) This file is available under the Apache License, Version 2.0.
+ * b) When publishing any derivative work or results obtained using this software, you agree to cite the following paper:
+ *    Tomas Koutny and Martin Ubl, "SmartCGMS as a Testbed for a Blood-Glucose Level Prediction and/or 
+ *    Control Challenge with (an FDA-Accepted) Diabetic Patient Simulation", Procedia Computer Science,  
+ *    Volume 177, pp. 354-362, 2020
+ */
+
+#include "startup_profiler.h"
+
+#if defined(SCGMS_STARTUP_PROFILER)
+
+#include <scgms/rtl/FilterLib.h>
+#include <scgms/utils/heap_profiler.h>
+#include <scgms/utils/string_utils.h>
+
+#include <array>
+#include <algorithm>
+#include <cstdio>
+
+#if defined(ESP32) || defined(WASM)
+#include <atomic>
+#include <chrono>
+#elif defined(FREERTOS)
+extern "C" {
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+}
+#endif
+
+namespace {
+	//fixed capacity, so that recording neither allocates, nor skews the measured phases
+	constexpr size_t Max_Records = 256;
+	std::array<startup_profiler::TPhase_Record, Max_Records> Records;
+#if defined(ESP32) || defined(WASM)
+	std::atomic<size_t> Records_Used{ 0 };		//the parallel build records from the worker threads too
+#elif defined(FREERTOS)
+	size_t Records_Used = 0;
+#endif
+
+	uint64_t Now_us() noexcept {
+#if defined(ESP32) || defined(WASM)
+		return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+#elif defined(FREERTOS)
+		//tick resolution only, typically a millisecond
+		return static_cast<uint64_t>(xTaskGetTickCount()) * portTICK_PERIOD_MS * 1000;
+#endif
+	}
+}
+
+namespace startup_profiler {
+
+	CPhase_Scope::CPhase_Scope(const NPhase phase, const GUID &filter_id) noexcept :
+		mPhase(phase), mFilter_Id(filter_id), mStart_us(Now_us()), mStart_Bytes(heap_profiler::Allocated_Bytes()), mStart_Allocations(heap_profiler::Allocation_Count()) {
+	}
+
+	CPhase_Scope::~CPhase_Scope() noexcept {
+		const size_t index = Records_Used++;
+		if (index >= Max_Records)
+			return;
+
+		Records[index] = TPhase_Record{ mPhase, mFilter_Id, Now_us() - mStart_us, heap_profiler::Allocated_Bytes() - mStart_Bytes, heap_profiler::Allocation_Count() - mStart_Allocations };
+	}
+
+	void Reset() noexcept {
+		Records_Used = 0;
+	}
+
+	size_t Record_Count() noexcept {
+		return std::min<size_t>(Records_Used, Max_Records);
+	}
+
+	bool Get_Record(const size_t index, TPhase_Record &record) noexcept {
+		if (index >= Record_Count())
+			return false;
+
+		record = Records[index];
+		return true;
+	}
+
+	const char* Phase_Name(const NPhase phase) noexcept {
+		switch (phase) {
+			case NPhase::Ini_Load: return "ini load";
+			case NPhase::Section_Sort: return "section sort";
+			case NPhase::Descriptor_Resolution: return "descriptor resolution";
+			case NPhase::Parameter_Parsing: return "parameter parsing";
+			case NPhase::Filter_Construction: return "filter construction";
+			case NPhase::Configure: return "configure";
+			case NPhase::Feedback_Wiring: return "feedback wiring";
+			default: return "unknown";
+		}
+	}
+
+	void Report(void (*print_line)(const char *line)) {
+		if (!print_line)
+			return;
+
+		std::array<TPhase_Record, static_cast<size_t>(NPhase::count)> totals{};
+		char line[160];
+
+		const size_t record_count = Record_Count();
+		for (size_t i = 0; i < record_count; i++) {
+			const TPhase_Record &record = Records[i];
+
+			std::string filter_name = "chain";
+			if (!Is_Invalid_GUID(record.filter_id)) {
+				scgms::TFilter_Descriptor desc = scgms::Null_Filter_Descriptor;
+				filter_name = scgms::get_filter_descriptor_by_id(record.filter_id, desc) ? Narrow_WChar(desc.description) : Narrow_WString(GUID_To_WString(record.filter_id));
+			}
+
+			snprintf(line, sizeof(line), "%-22s %-32s %10llu us %8zu B %5zu allocs", Phase_Name(record.phase), filter_name.c_str(),
+				static_cast<unsigned long long>(record.elapsed_us), record.bytes_allocated, record.allocations);
+			print_line(line);
+
+			TPhase_Record &total = totals[static_cast<size_t>(record.phase)];
+			total.elapsed_us += record.elapsed_us;
+			total.bytes_allocated += record.bytes_allocated;
+			total.allocations += record.allocations;
+		}
+
+		for (size_t i = 0; i < totals.size(); i++) {
+			snprintf(line, sizeof(line), "%-22s %-32s %10llu us %8zu B %5zu allocs", Phase_Name(static_cast<NPhase>(i)), "total",
+				static_cast<unsigned long long>(totals[i].elapsed_us), totals[i].bytes_allocated, totals[i].allocations);
+			print_line(line);
+		}
+
+		if (Records_Used >= Max_Records)
+			print_line("startup profiler: record capacity exhausted, later phases were not recorded");
+	}
+}
+
+#endif
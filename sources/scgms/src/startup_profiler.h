@@ -0,0 +1,103 @@
+/**
+ * SmartCGMS - continuous glucose monitoring and controlling framework
+ * https://diabetes.zcu.cz/
+ *
+ * Copyright (c) since 2018 University of West Bohemia.
+ *
+ * Contact:
+ * diabetes@mail.kiv.zcu.cz
+ * Medical Informatics, Department of Computer Science and Engineering
+ * Faculty of Applied Sciences, University of West Bohemia
+ * Univerzitni 8, 301 00 Pilsen
+ * Czech Republic
+ * 
+ * 
+ * Purpose of this software:
+ * This software is intended to demonstrate work of the diabetes.zcu.cz research
+ * group to other scientists, to complement our published papers. It is strictly
+ * prohibited to use this software for diagnosis or treatment of any medical condition,
+ * without obtaining all required approvals from respective regulatory bodies.
+ *
+ * Especially, a diabetic patient is warned that unauthorized use of this software
+ * may result into severe injure, including death.
+ *
+ *
+ * Licensing terms:
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * a) This file is available under the Apache License, Version 2.0.
+ * b) When publishing any derivative work or results obtained using this software, you agree to cite the following paper:
+ *    Tomas Koutny and Martin Ubl, "SmartCGMS as a Testbed for a Blood-Glucose Level Prediction and/or 
+ *    Control Challenge with (an FDA-Accepted) Diabetic Patient Simulation", Procedia Computer Science,  
+ *    Volume 177, pp. 354-362, 2020
+ */
+
+#pragma once
+
+//Phase timing of the filter chain construction, compiled in with SCGMS_STARTUP_PROFILER only.
+//Each SCGMS_STARTUP_PHASE scope records its duration and the bytes allocated meanwhile, as counted by utils/heap_profiler,
+//optionally per filter. The chain is expected to be built by a single thread at a time;
+//the allocations of any other thread running concurrently are counted too - including those of the parallel build's
+//workers, whose Configure phases overlap.
+
+#if defined(SCGMS_STARTUP_PROFILER)
+
+#include <scgms/rtl/guid.h>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace startup_profiler {
+
+	enum class NPhase : uint8_t {
+		Ini_Load = 0,
+		Section_Sort,
+		Descriptor_Resolution,
+		Parameter_Parsing,
+		Filter_Construction,	//create_filter_body
+		Configure,
+		Feedback_Wiring,
+		count
+	};
+
+	struct TPhase_Record {
+		NPhase phase;
+		GUID filter_id;				//Invalid_GUID for the chain-wide phases
+		uint64_t elapsed_us;
+		size_t bytes_allocated;
+		size_t allocations;
+	};
+
+	class CPhase_Scope {
+	protected:
+		const NPhase mPhase;
+		const GUID mFilter_Id;
+		const uint64_t mStart_us;
+		const size_t mStart_Bytes;
+		const size_t mStart_Allocations;
+	public:
+		CPhase_Scope(const NPhase phase, const GUID &filter_id = Invalid_GUID) noexcept;
+		~CPhase_Scope() noexcept;
+	};
+
+	void Reset() noexcept;		//discards the records collected so far
+	size_t Record_Count() noexcept;
+	bool Get_Record(const size_t index, TPhase_Record &record) noexcept;
+
+	//one line per record, the per-phase totals follow
+	void Report(void (*print_line)(const char *line));
+
+	const char* Phase_Name(const NPhase phase) noexcept;
+}
+
+#define SCGMS_STARTUP_PHASE_NAME_CAT(a, b) a##b
+#define SCGMS_STARTUP_PHASE_NAME(line) SCGMS_STARTUP_PHASE_NAME_CAT(startup_phase_scope_, line)
+#define SCGMS_STARTUP_PHASE(phase, ...) startup_profiler::CPhase_Scope SCGMS_STARTUP_PHASE_NAME(__LINE__){ startup_profiler::NPhase::phase, ##__VA_ARGS__ }
+
+#else
+
+#define SCGMS_STARTUP_PHASE(phase, ...)
+
+#endif
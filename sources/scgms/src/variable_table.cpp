@@ -0,0 +1,114 @@
+/**
+ * SmartCGMS - continuous glucose monitoring and controlling framework
+ * https://diabetes.zcu.cz/
+ *
+ * Copyright (c) since 2018 University of West Bohemia.
+ *
+ * Contact:
+ * diabetes@mail.kiv.zcu.cz
+ * Medical Informatics, Department of Computer Science and Engineering
+ * Faculty of Applied Sciences, University of West Bohemia
+ * Univerzitni 8, 301 00 Pilsen
+ * Czech Republic
+ * 
+ * 
+ * Purpose of this software:
+ * This software is intended to demonstrate work of the diabetes.zcu.cz research
+ * group to other scientists, to complement our published papers. It is strictly
+ * prohibited to use this software for diagnosis or treatment of any medical condition,
+ * without obtaining all required approvals from respective regulatory bodies.
+ *
+ * Especially, a diabetic patient is warned that unauthorized use of this software
+ * may result into severe injure, including death.
+ *
+ *
+ * Licensing terms:
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * a) This file is available under the Apache License, Version 2.0.
+ * b) When publishing any derivative work or results obtained using this software, you agree to cite the following paper:
+ *    Tomas Koutny and Martin Ubl, "SmartCGMS as a Testbed for a Blood-Glucose Level Prediction and/or 
+ *    Control Challenge with (an FDA-Accepted) Diabetic Patient Simulation", Procedia Computer Science,  
+ *    Volume 177, pp. 354-362, 2020
+ */
+
+#include "variable_table.h"
+
+CVariable_Table::THandle CVariable_Table::Intern_Unguarded(const intern_pool::TString name) {
+	auto iter = mNames.find(name);
+	if (iter != mNames.end())
+		return iter->second;
+
+	const THandle handle = mVariables.size();
+	mVariables.push_back(TVariable{});
+	mNames.emplace(name, handle);
+	return handle;
+}
+
+CVariable_Table::THandle CVariable_Table::Bind(const std::wstring &name) {
+#if defined(ESP32)
+	std::lock_guard<std::mutex> guard{ mGuard };
+#endif
+	return Intern_Unguarded(intern_pool::Intern(name));
+}
+
+uint64_t CVariable_Table::Version(const THandle handle) const {
+#if defined(ESP32)
+	std::lock_guard<std::mutex> guard{ mGuard };
+#endif
+	return handle < mVariables.size() ? mVariables[handle].version : 0;
+}
+
+HRESULT CVariable_Table::Set(const wchar_t *name, const wchar_t *value) {
+	if (!name || (*name == 0))
+		return E_INVALIDARG;
+
+#if defined(ESP32)
+	std::lock_guard<std::mutex> guard{ mGuard };
+#endif
+	TVariable &variable = mVariables[Intern_Unguarded(intern_pool::Intern(name))];
+	if (value) {
+		if (variable.set && (variable.value == value))
+			return S_FALSE;		//no change, no need to evaluate it again
+
+		variable.value = value;
+		variable.set = true;
+	}
+	else {
+		if (!variable.set)
+			return S_FALSE;
+
+		variable.value.clear();
+		variable.set = false;
+	}
+
+	variable.version++;
+	return S_OK;
+}
+
+std::tuple<HRESULT, std::wstring> CVariable_Table::Get(const std::wstring &name) const {
+#if defined(ESP32)
+	std::lock_guard<std::mutex> guard{ mGuard };
+#endif
+	auto iter = mNames.find(intern_pool::Find(name.c_str()));
+	if ((iter != mNames.end()) && mVariables[iter->second].set)
+		return { S_OK, mVariables[iter->second].value };
+
+	return { E_NOT_SET, std::wstring{} };
+}
+
+std::vector<std::tuple<std::wstring, std::wstring>> CVariable_Table::Get_All() const {
+#if defined(ESP32)
+	std::lock_guard<std::mutex> guard{ mGuard };
+#endif
+	std::vector<std::tuple<std::wstring, std::wstring>> result;
+	for (const auto &name : mNames) {
+		const TVariable &variable = mVariables[name.second];
+		if (variable.set)
+			result.emplace_back(name.first, variable.value);
+	}
+
+	return result;
+}
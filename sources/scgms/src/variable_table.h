@@ -0,0 +1,81 @@
+/**
+ * SmartCGMS - continuous glucose monitoring and controlling framework
+ * https://diabetes.zcu.cz/
+ *
+ * Copyright (c) since 2018 University of West Bohemia.
+ *
+ * Contact:
+ * diabetes@mail.kiv.zcu.cz
+ * Medical Informatics, Department of Computer Science and Engineering
+ * Faculty of Applied Sciences, University of West Bohemia
+ * Univerzitni 8, 301 00 Pilsen
+ * Czech Republic
+ * 
+ * 
+ * Purpose of this software:
+ * This software is intended to demonstrate work of the diabetes.zcu.cz research
+ * group to other scientists, to complement our published papers. It is strictly
+ * prohibited to use this software for diagnosis or treatment of any medical condition,
+ * without obtaining all required approvals from respective regulatory bodies.
+ *
+ * Especially, a diabetic patient is warned that unauthorized use of this software
+ * may result into severe injure, including death.
+ *
+ *
+ * Licensing terms:
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * a) This file is available under the Apache License, Version 2.0.
+ * b) When publishing any derivative work or results obtained using this software, you agree to cite the following paper:
+ *    Tomas Koutny and Martin Ubl, "SmartCGMS as a Testbed for a Blood-Glucose Level Prediction and/or 
+ *    Control Challenge with (an FDA-Accepted) Diabetic Patient Simulation", Procedia Computer Science,  
+ *    Volume 177, pp. 354-362, 2020
+ */
+
+#pragma once
+
+#include <scgms/rtl/hresult.h>
+
+#include "intern_pool.h"
+
+#include <string>
+#include <vector>
+#include <map>
+#include <tuple>
+
+#if defined(ESP32)
+#include <mutex>
+#endif
+
+//Chain-level $(variable) values, shared by all the parameters of a chain configuration.
+//Each variable gets a slot, once its name is first bound, with a version incremented by every change.
+//The parameters keep the typed value they have evaluated together with the versions it was evaluated at,
+//so that they evaluate the variable again only once it changes.
+class CVariable_Table {
+public:
+	using THandle = size_t;
+	static constexpr THandle Invalid_Handle = static_cast<THandle>(-1);
+protected:
+	struct TVariable {
+		std::wstring value;
+		bool set = false;			//not set falls back to the OS variable
+		uint64_t version = 1;
+	};
+
+#if defined(ESP32)
+	mutable std::mutex mGuard;
+#endif
+	std::map<intern_pool::TString, THandle> mNames;		//the names are interned, so that the chains share them
+	std::vector<TVariable> mVariables;
+
+	THandle Intern_Unguarded(const intern_pool::TString name);
+public:
+	THandle Bind(const std::wstring &name);				//finds or creates the variable's slot
+	uint64_t Version(const THandle handle) const;
+
+	HRESULT Set(const wchar_t *name, const wchar_t *value);		//nullptr value erases the variable
+	std::tuple<HRESULT, std::wstring> Get(const std::wstring &name) const;	//E_NOT_SET if not set in the table
+	std::vector<std::tuple<std::wstring, std::wstring>> Get_All() const;		//names and values of the set variables, e.g.; to copy them
+};
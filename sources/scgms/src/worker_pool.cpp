@@ -0,0 +1,143 @@
+/**
+ * SmartCGMS - continuous glucose monitoring and controlling framework
+ * https://diabetes.zcu.cz/
+ *
+ * Copyright (c) since 2018 University of West Bohemia.
+ *
+ * Contact:
+ * diabetes@mail.kiv.zcu.cz
+ * Medical Informatics, Department of Computer Science and Engineering
+ * Faculty of Applied Sciences, University of West Bohemia
+ * Univerzitni 8, 301 00 Pilsen
+ * Czech Republic
+ * 
+ * 
+ * Purpose of this software:
+ * This software is intended to demonstrate work of the diabetes.zcu.cz research
+ * group to other scientists, to complement our published papers. It is strictly
+ * prohibited to use this software for diagnosis or treatment of any medical condition,
+ * without obtaining all required approvals from respective regulatory bodies.
+ *
+ * Especially, a diabetic patient is warned that unauthorized use of this software
+ * may result into severe injure, including death.
+ *
+ *
+ * Licensing terms:
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * a) This file is available under the Apache License, Version 2.0.
+ * b) When publishing any derivative work or results obtained using this software, you agree to cite the following paper:
+ *    Tomas Koutny and Martin Ubl, "SmartCGMS as a Testbed for a Blood-Glucose Level Prediction and/or 
+ *    Control Challenge with (an FDA-Accepted) Diabetic Patient Simulation", Procedia Computer Science,  
+ *    Volume 177, pp. 354-362, 2020
+ */
+
+#include "worker_pool.h"
+
+#if defined(ESP32)
+
+CWorker_Pool::CWorker_Pool(const size_t thread_count) {
+#if defined(SCGMS_SINGLE_THREADED_REFCNT)
+	//the objects passed to the jobs cannot be shared across threads, so that the calling thread does all the work
+	const size_t effective_count = 1;
+	(void)thread_count;
+#else
+	size_t effective_count = thread_count > 0 ? thread_count : static_cast<size_t>(std::thread::hardware_concurrency());
+	if (effective_count == 0) effective_count = 1;
+#endif
+
+	//the calling thread participates in Parallel_For, hence we need one worker less
+	for (size_t i = 1; i < effective_count; i++)
+		mWorkers.push_back(std::thread{ &CWorker_Pool::Worker_Loop, this });
+}
+
+CWorker_Pool::~CWorker_Pool() {
+	{
+		std::lock_guard<std::mutex> lock{ mGuard };
+		mTerminating = true;
+	}
+	mWork_Available.notify_all();
+
+	for (auto &worker : mWorkers)
+		if (worker.joinable())
+			worker.join();
+}
+
+size_t CWorker_Pool::Thread_Count() const {
+	return mWorkers.size() + 1;
+}
+
+void CWorker_Pool::Run_Jobs(std::unique_lock<std::mutex> &lock) {
+	while (mNext_Index < mJob_Count) {
+		const size_t index = mNext_Index++;
+		const TJob *job = mJob;
+
+		lock.unlock();
+		(*job)(index);
+		lock.lock();
+
+		mPending_Count--;
+		if (mPending_Count == 0)
+			mWork_Done.notify_all();
+	}
+}
+
+void CWorker_Pool::Worker_Loop() {
+	std::unique_lock<std::mutex> lock{ mGuard };
+	while (true) {
+		mWork_Available.wait(lock, [this]() { return mTerminating || (mNext_Index < mJob_Count); });
+		if (mTerminating)
+			return;
+
+		Run_Jobs(lock);
+	}
+}
+
+void CWorker_Pool::Parallel_For(const size_t count, const TJob &job) {
+	if (count == 0) return;
+
+	if (mWorkers.empty() || (count == 1)) {
+		for (size_t i = 0; i < count; i++)
+			job(i);
+		return;
+	}
+
+	std::lock_guard<std::mutex> call_guard{ mCall_Guard };
+	std::unique_lock<std::mutex> lock{ mGuard };
+
+	mJob = &job;
+	mJob_Count = count;
+	mNext_Index = 0;
+	mPending_Count = count;
+	mWork_Available.notify_all();
+
+	Run_Jobs(lock);
+	mWork_Done.wait(lock, [this]() { return mPending_Count == 0; });
+
+	mJob = nullptr;
+	mJob_Count = 0;
+	mNext_Index = 0;
+}
+
+#elif defined(FREERTOS) || defined(WASM)
+
+CWorker_Pool::CWorker_Pool(const size_t thread_count) {
+	//
+}
+
+CWorker_Pool::~CWorker_Pool() {
+	//
+}
+
+size_t CWorker_Pool::Thread_Count() const {
+	return 1;
+}
+
+void CWorker_Pool::Parallel_For(const size_t count, const TJob &job) {
+	for (size_t i = 0; i < count; i++)
+		job(i);
+}
+
+#endif
@@ -0,0 +1,77 @@
+/**
+ * SmartCGMS - continuous glucose monitoring and controlling framework
+ * https://diabetes.zcu.cz/
+ *
+ * Copyright (c) since 2018 University of West Bohemia.
+ *
+ * Contact:
+ * diabetes@mail.kiv.zcu.cz
+ * Medical Informatics, Department of Computer Science and Engineering
+ * Faculty of Applied Sciences, University of West Bohemia
+ * Univerzitni 8, 301 00 Pilsen
+ * Czech Republic
+ * 
+ * 
+ * Purpose of this software:
+ * This software is intended to demonstrate work of the diabetes.zcu.cz research
+ * group to other scientists, to complement our published papers. It is strictly
+ * prohibited to use this software for diagnosis or treatment of any medical condition,
+ * without obtaining all required approvals from respective regulatory bodies.
+ *
+ * Especially, a diabetic patient is warned that unauthorized use of this software
+ * may result into severe injure, including death.
+ *
+ *
+ * Licensing terms:
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * a) This file is available under the Apache License, Version 2.0.
+ * b) When publishing any derivative work or results obtained using this software, you agree to cite the following paper:
+ *    Tomas Koutny and Martin Ubl, "SmartCGMS as a Testbed for a Blood-Glucose Level Prediction and/or 
+ *    Control Challenge with (an FDA-Accepted) Diabetic Patient Simulation", Procedia Computer Science,  
+ *    Volume 177, pp. 354-362, 2020
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+
+#if defined(ESP32)
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <vector>
+#endif
+
+//Fixed set of worker threads, which execute indexed jobs in parallel.
+//On platforms without threads (FREERTOS, WASM), and with SCGMS_SINGLE_THREADED_REFCNT, the jobs are executed serially by the calling thread.
+class CWorker_Pool {
+public:
+	using TJob = std::function<void(const size_t index)>;
+protected:
+#if defined(ESP32)
+	std::vector<std::thread> mWorkers;
+	std::mutex mCall_Guard;		//serializes concurrent Parallel_For calls
+	std::mutex mGuard;
+	std::condition_variable mWork_Available, mWork_Done;
+	const TJob *mJob = nullptr;
+	size_t mJob_Count = 0;
+	size_t mNext_Index = 0;
+	size_t mPending_Count = 0;
+	bool mTerminating = false;
+
+	void Worker_Loop();
+	void Run_Jobs(std::unique_lock<std::mutex> &lock);
+#endif
+public:
+	CWorker_Pool(const size_t thread_count = 0);	//zero selects the hardware concurrency; the calling thread counts as one of them
+	~CWorker_Pool();
+
+	size_t Thread_Count() const;
+
+	//calls job(index) for every index in [0, count) and returns once all of them have completed
+	void Parallel_For(const size_t count, const TJob &job);
+};
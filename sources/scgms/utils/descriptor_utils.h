@@ -37,6 +37,16 @@
 #pragma once
 
 #include "../rtl/hresult.h"
+#include "../rtl/guid.h"
+
+#include <vector>
+#include <cwchar>
+#include <string_view>
+#if defined(EMBEDDED)
+	#include <algorithm>
+#else
+	#include <unordered_map>
+#endif
 
 template <typename T, typename A = std::allocator<T>, typename V = std::vector<T, A>>
 HRESULT do_get_descriptors(const V &descriptors, T **begin, T **end) {
@@ -93,3 +103,176 @@ R Name_Parameters_First_Followers(const wchar_t* first, const wchar_t* follower_
 
 	return result;
 }
+
+
+//Lookup of descriptors by id and by description, built once over a descriptor array that no longer changes.
+//Embedded builds have the descriptor set fixed at link time, so they build a minimal perfect hash by hash-and-displace:
+//the keys are split into small buckets, and each bucket gets the displacement (the seed of the second hash), which places
+//its keys into free slots. A lookup reads the bucket's displacement and probes a single slot; each table takes
+//about 2.5 bytes per descriptor. The other builds use std::unordered_map.
+//Duplicate ids or descriptions resolve to the first descriptor, as the linear search did.
+template <typename T>
+class CDescriptor_Index {
+protected:
+	const T *mDescriptors = nullptr;
+	size_t mCount = 0;
+
+	static size_t Id_Hash(const GUID &id, const uint64_t seed) noexcept {
+		uint64_t halves[2];
+		memcpy(halves, &id, sizeof(halves));
+		return static_cast<size_t>(Mix(halves[0] ^ seed) ^ Mix(halves[1] + seed));
+	}
+
+	static size_t Description_Hash(const std::wstring_view description, const uint64_t seed) noexcept {
+		uint64_t hash = 14695981039346656037ULL ^ seed;
+		for (const wchar_t c : description) {
+			hash ^= static_cast<uint64_t>(c);
+			hash *= 1099511628211ULL;
+		}
+		return static_cast<size_t>(Mix(hash));
+	}
+
+	static uint64_t Mix(uint64_t x) noexcept {
+		x += 0x9E3779B97F4A7C15ULL;
+		x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+		x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+		return x ^ (x >> 31);
+	}
+
+#if defined(EMBEDDED)
+	static constexpr uint16_t Empty_Slot = 0xFFFF;
+	static constexpr size_t Keys_Per_Bucket = 4;
+
+	struct TPerfect_Table {
+		std::vector<uint16_t> displacements;	//per bucket; the slot hash is seeded with the displacement + 1, as the bucket hash uses zero
+		std::vector<uint16_t> slots;			//descriptor indices
+	};
+
+	TPerfect_Table mBy_Id, mBy_Description;
+
+	template <typename K, typename H, typename E>
+	void Build_Perfect_Table(TPerfect_Table &table, K key_of, H hash, E equal) {
+		size_t bucket_count = std::max<size_t>(1, (mCount + Keys_Per_Bucket - 1) / Keys_Per_Bucket);
+		size_t slot_count = mCount;
+
+		for (;;) {
+			//a duplicate key is left out, so that it keeps the first descriptor
+			std::vector<std::vector<uint16_t>> buckets(bucket_count);
+			for (size_t i = 0; i < mCount; i++) {
+				const auto key = key_of(mDescriptors[i]);
+				if (!key.first)
+					continue;
+
+				auto &bucket = buckets[hash(key.second, 0) % bucket_count];
+				if (std::none_of(bucket.begin(), bucket.end(), [&](const uint16_t other) { return equal(key_of(mDescriptors[other]).second, key.second); }))
+					bucket.push_back(static_cast<uint16_t>(i));
+			}
+
+			//the largest buckets first, while there are many free slots
+			std::vector<size_t> order(bucket_count);
+			for (size_t i = 0; i < bucket_count; i++)
+				order[i] = i;
+			std::stable_sort(order.begin(), order.end(), [&buckets](const size_t a, const size_t b) { return buckets[a].size() > buckets[b].size(); });
+
+			table.displacements.assign(bucket_count, 0);
+			table.slots.assign(slot_count, Empty_Slot);
+
+			bool placed_all = true;
+			std::vector<size_t> placement;
+			for (size_t b = 0; (b < bucket_count) && placed_all && !buckets[order[b]].empty(); b++) {
+				const auto &bucket = buckets[order[b]];
+
+				placed_all = false;
+				for (size_t displacement = 0; (displacement < Empty_Slot) && !placed_all; displacement++) {
+					placement.clear();
+					for (const uint16_t index : bucket) {
+						const size_t slot = hash(key_of(mDescriptors[index]).second, displacement + 1) % slot_count;
+						if ((table.slots[slot] != Empty_Slot) || (std::find(placement.begin(), placement.end(), slot) != placement.end()))
+							break;
+						placement.push_back(slot);
+					}
+
+					if (placement.size() == bucket.size()) {
+						for (size_t k = 0; k < bucket.size(); k++)
+							table.slots[placement[k]] = bucket[k];
+						table.displacements[order[b]] = static_cast<uint16_t>(displacement);
+						placed_all = true;
+					}
+				}
+			}
+
+			if (placed_all)
+				return;
+
+			//smaller buckets are easier to place; once they hold a single key, we give up the minimality
+			if (bucket_count < mCount)
+				bucket_count *= 2;
+			else
+				slot_count += 1 + slot_count / 8;
+		}
+	}
+
+	template <typename K, typename H, typename E>
+	const T* Find(const TPerfect_Table &table, const K &key, H hash, E equal) const noexcept {
+		if (table.slots.empty())
+			return nullptr;
+
+		const uint64_t displacement = table.displacements[hash(key, 0) % table.displacements.size()];
+		const uint16_t slot = table.slots[hash(key, displacement + 1) % table.slots.size()];
+		return ((slot != Empty_Slot) && equal(mDescriptors[slot], key)) ? &mDescriptors[slot] : nullptr;
+	}
+#else
+	struct TDescription_Hash {
+		size_t operator()(const std::wstring_view description) const noexcept { return Description_Hash(description, 0); }
+	};
+
+	std::unordered_map<GUID, size_t> mBy_Id;
+	std::unordered_map<std::wstring_view, size_t, TDescription_Hash> mBy_Description;
+#endif
+
+public:
+	CDescriptor_Index(const T *begin, const T *end) : mDescriptors(begin), mCount(begin ? static_cast<size_t>(end - begin) : 0) {
+#if defined(EMBEDDED)
+		if ((mCount == 0) || (mCount >= Empty_Slot))
+			return;
+
+		Build_Perfect_Table(mBy_Id, [](const T &desc) { return std::make_pair(true, desc.id); },
+			[](const GUID &id, const uint64_t seed) { return Id_Hash(id, seed); },
+			[](const GUID &a, const GUID &b) { return a == b; });
+
+		Build_Perfect_Table(mBy_Description, [](const T &desc) { return std::make_pair(desc.description != nullptr, std::wstring_view{ desc.description ? desc.description : L"" }); },
+			[](const std::wstring_view description, const uint64_t seed) { return Description_Hash(description, seed); },
+			[](const std::wstring_view a, const std::wstring_view b) { return a == b; });
+#else
+		for (size_t i = 0; i < mCount; i++) {
+			mBy_Id.emplace(mDescriptors[i].id, i);		//emplace keeps the first of duplicates
+			if (mDescriptors[i].description)
+				mBy_Description.emplace(mDescriptors[i].description, i);
+		}
+#endif
+	}
+
+	const T* Find_By_Id(const GUID &id) const noexcept {
+#if defined(EMBEDDED)
+		return Find(mBy_Id, id, [](const GUID &key, const uint64_t seed) { return Id_Hash(key, seed); },
+			[](const T &desc, const GUID &key) { return desc.id == key; });
+#else
+		const auto iter = mBy_Id.find(id);
+		return iter != mBy_Id.end() ? &mDescriptors[iter->second] : nullptr;
+#endif
+	}
+
+	const T* Find_By_Description(const wchar_t *description) const noexcept {
+		if (!description)
+			return nullptr;
+
+		const std::wstring_view key{ description };
+#if defined(EMBEDDED)
+		return Find(mBy_Description, key, [](const std::wstring_view key, const uint64_t seed) { return Description_Hash(key, seed); },
+			[](const T &desc, const std::wstring_view key) { return desc.description && (key == desc.description); });
+#else
+		const auto iter = mBy_Description.find(key);
+		return iter != mBy_Description.end() ? &mDescriptors[iter->second] : nullptr;
+#endif
+	}
+};
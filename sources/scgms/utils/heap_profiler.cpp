@@ -0,0 +1,286 @@
+/**
+ * SmartCGMS - continuous glucose monitoring and controlling framework
+ * https://diabetes.zcu.cz/
+ *
+ * Copyright (c) since 2018 University of West Bohemia.
+ *
+ * Contact:
+ * diabetes@mail.kiv.zcu.cz
+ * Medical Informatics, Department of Computer Science and Engineering
+ * Faculty of Applied Sciences, University of West Bohemia
+ * Univerzitni 8, 301 00 Pilsen
+ * Czech Republic
+ * 
+ * 
+ * Purpose of this software:
+ * This software is intended to demonstrate work of the diabetes.zcu.cz research
+ * group to other scientists, to complement our published papers. It is strictly
+ * prohibited to use this software for diagnosis or treatment of any medical condition,
+ * without obtaining all required approvals from respective regulatory bodies.
+ *
+ * Especially, a diabetic patient is warned that unauthorized use of this software
+ * may result into severe injure, including death.
+ *
+ *
+ * Licensing terms:
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * a) This file is available under the Apache License, Version 2.0.
+ * b) When publishing any derivative work or results obtained using this software, you agree to cite the following paper:
+ *    Tomas Koutny and Martin Ubl, "SmartCGMS as a Testbed for a Blood-Glucose Level Prediction and/or 
+ *    Control Challenge with (an FDA-Accepted) Diabetic Patient Simulation", Procedia Computer Science,  
+ *    Volume 177, pp. 354-362, 2020
+ */
+
+#include "heap_profiler.h"
+
+#if defined(SCGMS_HEAP_PROFILER)
+
+#include <array>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+#if defined(ESP32) || defined(WASM)
+#include <atomic>
+#endif
+
+namespace {
+#if defined(ESP32) || defined(WASM)
+	using TCounter = std::atomic<size_t>;
+#elif defined(FREERTOS)
+	using TCounter = size_t;
+#endif
+
+	struct TCounters {
+		TCounter allocations{ 0 };
+		TCounter frees{ 0 };
+		TCounter live_bytes{ 0 };
+		TCounter peak_bytes{ 0 };
+		TCounter total_bytes{ 0 };
+	};
+
+	constexpr size_t Tag_Count = static_cast<size_t>(heap_profiler::NTag::count);
+
+	//fixed, so that counting never allocates
+	std::array<TCounters, Tag_Count> Tag_Counters;
+	TCounters All_Counters;
+	std::array<TCounter, heap_profiler::Histogram_Bucket_Count> Histogram;
+
+#if defined(ESP32)
+	thread_local heap_profiler::NTag Current_Tag = heap_profiler::NTag::Other;
+#elif defined(FREERTOS) || defined(WASM)
+	heap_profiler::NTag Current_Tag = heap_profiler::NTag::Other;
+#endif
+
+	//right below the memory returned to the caller
+	struct THeader {
+		size_t size;
+		uint32_t offset;		//of the memory from the block start
+		heap_profiler::NTag tag;
+	};
+
+	static_assert(sizeof(THeader) <= heap_profiler::Header_Size, "the header does not fit the space reserved for it");
+	static_assert(heap_profiler::Header_Size >= alignof(std::max_align_t), "operator new would misalign the memory");
+
+	void Raise_Peak(TCounter &peak, const size_t value) noexcept {
+#if defined(ESP32) || defined(WASM)
+		size_t current = peak.load(std::memory_order_relaxed);
+		while ((value > current) && !peak.compare_exchange_weak(current, value, std::memory_order_relaxed))
+			;
+#elif defined(FREERTOS)
+		if (value > peak)
+			peak = value;
+#endif
+	}
+
+	void Count_Allocation(TCounters &counters, const size_t size) noexcept {
+		counters.allocations++;
+		counters.total_bytes += size;
+		const size_t live = (counters.live_bytes += size);
+		Raise_Peak(counters.peak_bytes, live);
+	}
+
+	void Count_Free(TCounters &counters, const size_t size) noexcept {
+		counters.frees++;
+		counters.live_bytes -= size;
+	}
+
+	size_t Histogram_Bucket(const size_t size) noexcept {
+		size_t bucket = 0;
+		for (size_t limit = 16; (size > limit) && (bucket + 1 < heap_profiler::Histogram_Bucket_Count); limit <<= 1)
+			bucket++;
+
+		return bucket;
+	}
+
+	void Fill_Stats(const TCounters &counters, heap_profiler::TTag_Stats &stats) noexcept {
+		stats.allocations = counters.allocations;
+		stats.frees = counters.frees;
+		stats.live_bytes = counters.live_bytes;
+		stats.peak_bytes = counters.peak_bytes;
+		stats.total_bytes = counters.total_bytes;
+	}
+
+	void* Tracked_New(const size_t size) noexcept {
+		void* block = std::malloc(heap_profiler::Header_Size + size);
+		return block ? heap_profiler::Track(block, heap_profiler::Header_Size, size, heap_profiler::NTag::Other) : nullptr;
+	}
+
+	void Tracked_Delete(void* memory) noexcept {
+		if (memory)
+			std::free(heap_profiler::Untrack(memory));
+	}
+}
+
+void* operator new(std::size_t size) {
+	void* memory = Tracked_New(size);
+	if (!memory)
+		throw std::bad_alloc{};
+	return memory;
+}
+
+void* operator new[](std::size_t size) {
+	void* memory = Tracked_New(size);
+	if (!memory)
+		throw std::bad_alloc{};
+	return memory;
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+	return Tracked_New(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+	return Tracked_New(size);
+}
+
+void operator delete(void* memory) noexcept {
+	Tracked_Delete(memory);
+}
+
+void operator delete[](void* memory) noexcept {
+	Tracked_Delete(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept {
+	Tracked_Delete(memory);
+}
+
+void operator delete[](void* memory, std::size_t) noexcept {
+	Tracked_Delete(memory);
+}
+
+namespace heap_profiler {
+
+	CTag_Scope::CTag_Scope(const NTag tag) noexcept : mPrevious(Current_Tag) {
+		if (mPrevious == NTag::Other)
+			Current_Tag = tag;
+	}
+
+	CTag_Scope::~CTag_Scope() noexcept {
+		Current_Tag = mPrevious;
+	}
+
+	void* Track(void* block, const size_t offset, const size_t size, const NTag untagged) noexcept {
+		const NTag tag = Current_Tag != NTag::Other ? Current_Tag : untagged;
+
+		uint8_t* memory = static_cast<uint8_t*>(block) + offset;
+		THeader* header = reinterpret_cast<THeader*>(memory - Header_Size);
+		header->size = size;
+		header->offset = static_cast<uint32_t>(offset);
+		header->tag = tag;
+
+		Count_Allocation(Tag_Counters[static_cast<size_t>(tag)], size);
+		Count_Allocation(All_Counters, size);
+		Histogram[Histogram_Bucket(size)]++;
+
+		return memory;
+	}
+
+	void* Untrack(void* memory) noexcept {
+		const THeader* header = reinterpret_cast<const THeader*>(static_cast<uint8_t*>(memory) - Header_Size);
+
+		Count_Free(Tag_Counters[static_cast<size_t>(header->tag)], header->size);
+		Count_Free(All_Counters, header->size);
+
+		return static_cast<uint8_t*>(memory) - header->offset;
+	}
+
+	void Get_Stats(THeap_Stats &stats) noexcept {
+		for (size_t i = 0; i < Tag_Count; i++)
+			Fill_Stats(Tag_Counters[i], stats.tags[i]);
+
+		TTag_Stats all;
+		Fill_Stats(All_Counters, all);
+		stats.live_bytes = all.live_bytes;
+		stats.peak_bytes = all.peak_bytes;
+		stats.total_bytes = all.total_bytes;
+		stats.allocations = all.allocations;
+		stats.frees = all.frees;
+
+		for (size_t i = 0; i < Histogram_Bucket_Count; i++)
+			stats.histogram[i] = Histogram[i];
+	}
+
+	size_t Allocated_Bytes() noexcept {
+		return All_Counters.total_bytes;
+	}
+
+	size_t Allocation_Count() noexcept {
+		return All_Counters.allocations;
+	}
+
+	void Reset_Peak() noexcept {
+		for (auto &counters : Tag_Counters)
+			counters.peak_bytes = static_cast<size_t>(counters.live_bytes);
+		All_Counters.peak_bytes = static_cast<size_t>(All_Counters.live_bytes);
+	}
+
+	const char* Tag_Name(const NTag tag) noexcept {
+		switch (tag) {
+			case NTag::Other: return "other";
+			case NTag::Events: return "events";
+			case NTag::Containers: return "containers";
+			case NTag::Config: return "config";
+			case NTag::Strings: return "strings";
+			default: return "unknown";
+		}
+	}
+
+	void Report(void (*print_line)(const char *line)) {
+		if (!print_line)
+			return;
+
+		THeap_Stats stats;
+		Get_Stats(stats);
+
+		char line[160];
+		snprintf(line, sizeof(line), "%-12s %10s %10s %12s %12s %14s", "tag", "allocs", "frees", "live B", "peak B", "total B");
+		print_line(line);
+
+		for (size_t i = 0; i < Tag_Count; i++) {
+			const TTag_Stats &tag = stats.tags[i];
+			snprintf(line, sizeof(line), "%-12s %10zu %10zu %12zu %12zu %14zu", Tag_Name(static_cast<NTag>(i)),
+				tag.allocations, tag.frees, tag.live_bytes, tag.peak_bytes, tag.total_bytes);
+			print_line(line);
+		}
+
+		snprintf(line, sizeof(line), "%-12s %10zu %10zu %12zu %12zu %14zu", "all",
+			stats.allocations, stats.frees, stats.live_bytes, stats.peak_bytes, stats.total_bytes);
+		print_line(line);
+
+		size_t limit = 16;
+		for (size_t i = 0; i < Histogram_Bucket_Count; i++, limit <<= 1) {
+			if (i + 1 < Histogram_Bucket_Count)
+				snprintf(line, sizeof(line), "allocations <= %6zu B %10zu", limit, stats.histogram[i]);
+			else
+				snprintf(line, sizeof(line), "allocations  > %6zu B %10zu", limit >> 1, stats.histogram[i]);
+			print_line(line);
+		}
+	}
+}
+
+#endif
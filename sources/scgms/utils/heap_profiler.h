@@ -0,0 +1,122 @@
+/**
+ * SmartCGMS - continuous glucose monitoring and controlling framework
+ * https://diabetes.zcu.cz/
+ *
+ * Copyright (c) since 2018 University of West Bohemia.
+ *
+ * Contact:
+ * diabetes@mail.kiv.zcu.cz
+ * Medical Informatics, Department of Computer Science and Engineering
+ * Faculty of Applied Sciences, University of West Bohemia
+ * Univerzitni 8, 301 00 Pilsen
+ * Czech Republic
+ * 
+ * 
+ * Purpose of this software:
+ * This software is intended to demonstrate work of the diabetes.zcu.cz research
+ * group to other scientists, to complement our published papers. It is strictly
+ * prohibited to use this software for diagnosis or treatment of any medical condition,
+ * without obtaining all required approvals from respective regulatory bodies.
+ *
+ * Especially, a diabetic patient is warned that unauthorized use of this software
+ * may result into severe injure, including death.
+ *
+ *
+ * Licensing terms:
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * a) This file is available under the Apache License, Version 2.0.
+ * b) When publishing any derivative work or results obtained using this software, you agree to cite the following paper:
+ *    Tomas Koutny and Martin Ubl, "SmartCGMS as a Testbed for a Blood-Glucose Level Prediction and/or 
+ *    Control Challenge with (an FDA-Accepted) Diabetic Patient Simulation", Procedia Computer Science,  
+ *    Volume 177, pp. 354-362, 2020
+ */
+
+#pragma once
+
+//Instrumented heap for setting the heap budgets, compiled in with SCGMS_HEAP_PROFILER.
+//It counts the operator new and _aligned_malloc allocations per tag, which SCGMS_HEAP_TAG scopes set for the current thread.
+//The outermost scope wins, so that e.g.; the strings of a loading configuration count as the configuration.
+//Untagged _aligned_malloc allocations count as the containers, untagged operator new ones as the other.
+
+//the startup profiler measures the allocations of the phases with it
+#if defined(SCGMS_STARTUP_PROFILER) && !defined(SCGMS_HEAP_PROFILER)
+	#define SCGMS_HEAP_PROFILER
+#endif
+
+#if defined(SCGMS_HEAP_PROFILER)
+
+#include <cstddef>
+#include <cstdint>
+
+namespace heap_profiler {
+
+	enum class NTag : uint8_t {
+		Other = 0,
+		Events,
+		Containers,
+		Config,
+		Strings,
+		count
+	};
+
+	//allocation sizes up to 16, 32, ..., 4096 bytes, and the larger ones
+	constexpr size_t Histogram_Bucket_Count = 10;
+
+	struct TTag_Stats {
+		size_t allocations;
+		size_t frees;
+		size_t live_bytes;
+		size_t peak_bytes;
+		size_t total_bytes;		//cumulative
+	};
+
+	struct THeap_Stats {
+		TTag_Stats tags[static_cast<size_t>(NTag::count)];
+		size_t live_bytes;
+		size_t peak_bytes;
+		size_t total_bytes;
+		size_t allocations;
+		size_t frees;
+		size_t histogram[Histogram_Bucket_Count];
+	};
+
+	class CTag_Scope {
+	protected:
+		const NTag mPrevious;
+	public:
+		CTag_Scope(const NTag tag) noexcept;
+		~CTag_Scope() noexcept;
+
+		CTag_Scope(const CTag_Scope&) = delete;
+		CTag_Scope& operator=(const CTag_Scope&) = delete;
+	};
+
+	//The allocator layer reserves offset >= Header_Size bytes in front of each block; Track keeps its bookkeeping there
+	//and returns block + offset to the caller, Untrack takes the caller's pointer and returns the block to free.
+	constexpr size_t Header_Size = 16;
+	void* Track(void* block, const size_t offset, const size_t size, const NTag untagged) noexcept;
+	void* Untrack(void* memory) noexcept;
+
+	void Get_Stats(THeap_Stats &stats) noexcept;
+	size_t Allocated_Bytes() noexcept;		//cumulative
+	size_t Allocation_Count() noexcept;		//cumulative
+	void Reset_Peak() noexcept;				//the peaks restart from the current live bytes
+
+	//the totals, one line per tag and the histogram
+	void Report(void (*print_line)(const char *line));
+
+	const char* Tag_Name(const NTag tag) noexcept;
+}
+
+#define SCGMS_HEAP_TAG_NAME_CAT(a, b) a##b
+#define SCGMS_HEAP_TAG_NAME(line) SCGMS_HEAP_TAG_NAME_CAT(heap_tag_scope_, line)
+#define SCGMS_HEAP_TAG(tag) heap_profiler::CTag_Scope SCGMS_HEAP_TAG_NAME(__LINE__){ heap_profiler::NTag::tag }
+
+#else
+
+#define SCGMS_HEAP_TAG(tag)
+
+#endif
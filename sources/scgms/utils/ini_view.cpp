@@ -0,0 +1,145 @@
+/**
+ * SmartCGMS - continuous glucose monitoring and controlling framework
+ * https://diabetes.zcu.cz/
+ *
+ * Copyright (c) since 2018 University of West Bohemia.
+ *
+ * Contact:
+ * diabetes@mail.kiv.zcu.cz
+ * Medical Informatics, Department of Computer Science and Engineering
+ * Faculty of Applied Sciences, University of West Bohemia
+ * Univerzitni 8, 301 00 Pilsen
+ * Czech Republic
+ * 
+ * 
+ * Purpose of this software:
+ * This software is intended to demonstrate work of the diabetes.zcu.cz research
+ * group to other scientists, to complement our published papers. It is strictly
+ * prohibited to use this software for diagnosis or treatment of any medical condition,
+ * without obtaining all required approvals from respective regulatory bodies.
+ *
+ * Especially, a diabetic patient is warned that unauthorized use of this software
+ * may result into severe injure, including death.
+ *
+ *
+ * Licensing terms:
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * a) This file is available under the Apache License, Version 2.0.
+ * b) When publishing any derivative work or results obtained using this software, you agree to cite the following paper:
+ *    Tomas Koutny and Martin Ubl, "SmartCGMS as a Testbed for a Blood-Glucose Level Prediction and/or 
+ *    Control Challenge with (an FDA-Accepted) Diabetic Patient Simulation", Procedia Computer Science,  
+ *    Volume 177, pp. 354-362, 2020
+ */
+
+#include "ini_view.h"
+
+namespace {
+	char Lower_ASCII(const char c) noexcept {
+		return ((c >= 'A') && (c <= 'Z')) ? static_cast<char>(c - 'A' + 'a') : c;
+	}
+
+	std::string_view Trim(std::string_view str) noexcept {
+		const char *blanks = " \t\r\n";
+		const size_t first = str.find_first_not_of(blanks);
+		if (first == std::string_view::npos)
+			return str.substr(str.size());	//keeps the data pointer valid for an empty value
+
+		const size_t last = str.find_last_not_of(blanks);
+		return str.substr(first, last - first + 1);
+	}
+}
+
+bool Equal_Ignore_Case(const std::string_view a, const std::string_view b) noexcept {
+	if (a.size() != b.size())
+		return false;
+
+	for (size_t i = 0; i < a.size(); i++) {
+		if (Lower_ASCII(a[i]) != Lower_ASCII(b[i]))
+			return false;
+	}
+
+	return true;
+}
+
+std::string_view CIni_View::TSection::Find_Value(const std::string_view key) const noexcept {
+	for (auto iter = entries.rbegin(); iter != entries.rend(); iter++) {
+		if (Equal_Ignore_Case(iter->key, key))
+			return iter->value;
+	}
+
+	return std::string_view{};
+}
+
+std::string_view CIni_View::TSection::Find_Value(const wchar_t *key) const noexcept {
+	for (auto iter = entries.rbegin(); iter != entries.rend(); iter++) {
+		const std::string_view &entry_key = iter->key;
+
+		size_t i = 0;
+		for (; i < entry_key.size(); i++) {
+			if ((key[i] == 0) || (key[i] >= 0x80) || (Lower_ASCII(entry_key[i]) != Lower_ASCII(static_cast<char>(key[i]))))
+				break;
+		}
+
+		if ((i == entry_key.size()) && (key[i] == 0))
+			return iter->value;
+	}
+
+	return std::string_view{};
+}
+
+CIni_View::TSection& CIni_View::Section(const std::string_view name) {
+	for (auto &section : mSections) {
+		if (Equal_Ignore_Case(section.name, name))
+			return section;
+	}
+
+	mSections.push_back(TSection{ name, {} });
+	return mSections.back();
+}
+
+bool CIni_View::Parse(const char *memory, const size_t len) {
+	mSections.clear();
+	if (!memory)
+		return false;
+
+	std::string_view text{ memory, len };
+	if ((text.size() >= 3) && (text.substr(0, 3) == "\xEF\xBB\xBF"))
+		text.remove_prefix(3);	//UTF-8 BOM
+
+	TSection *current = nullptr;
+	while (!text.empty()) {
+		const size_t eol = text.find('\n');
+		const std::string_view line = Trim(text.substr(0, eol));
+		text.remove_prefix(eol == std::string_view::npos ? text.size() : eol + 1);
+
+		if (line.empty() || (line[0] == ';') || (line[0] == '#'))
+			continue;
+
+		if (line[0] == '[') {
+			const size_t closing = line.find(']');
+			if (closing == std::string_view::npos)
+				return false;
+
+			current = &Section(Trim(line.substr(1, closing - 1)));
+			continue;
+		}
+
+		//lines without the equal sign are ignored as CSimpleIniW does
+		const size_t equal = line.find('=');
+		if (equal == std::string_view::npos)
+			continue;
+
+		//keys preceding any section go to the unnamed one, so that the caller can report them
+		if (!current)
+			current = &Section(std::string_view{ memory, 0 });
+
+		const std::string_view key = Trim(line.substr(0, equal));
+		if (!key.empty())
+			current->entries.push_back(TEntry{ key, Trim(line.substr(equal + 1)) });
+	}
+
+	return true;
+}
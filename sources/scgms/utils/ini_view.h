@@ -0,0 +1,71 @@
+/**
+ * SmartCGMS - continuous glucose monitoring and controlling framework
+ * https://diabetes.zcu.cz/
+ *
+ * Copyright (c) since 2018 University of West Bohemia.
+ *
+ * Contact:
+ * diabetes@mail.kiv.zcu.cz
+ * Medical Informatics, Department of Computer Science and Engineering
+ * Faculty of Applied Sciences, University of West Bohemia
+ * Univerzitni 8, 301 00 Pilsen
+ * Czech Republic
+ * 
+ * 
+ * Purpose of this software:
+ * This software is intended to demonstrate work of the diabetes.zcu.cz research
+ * group to other scientists, to complement our published papers. It is strictly
+ * prohibited to use this software for diagnosis or treatment of any medical condition,
+ * without obtaining all required approvals from respective regulatory bodies.
+ *
+ * Especially, a diabetic patient is warned that unauthorized use of this software
+ * may result into severe injure, including death.
+ *
+ *
+ * Licensing terms:
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * a) This file is available under the Apache License, Version 2.0.
+ * b) When publishing any derivative work or results obtained using this software, you agree to cite the following paper:
+ *    Tomas Koutny and Martin Ubl, "SmartCGMS as a Testbed for a Blood-Glucose Level Prediction and/or 
+ *    Control Challenge with (an FDA-Accepted) Diabetic Patient Simulation", Procedia Computer Science,  
+ *    Volume 177, pp. 354-362, 2020
+ */
+
+#pragma once
+
+#include <string_view>
+#include <vector>
+
+//In-place tokenizer of an UTF-8 ini text, which replaces CSimpleIniW for loading the chain configuration.
+//Sections, keys and values are views into the original text, hence it must outlive the CIni_View;
+//nothing is widened, so the caller converts just the values it actually needs.
+//It follows the CSimpleIniW defaults: ; and # comment lines, case-insensitive section and key names,
+//merged duplicate sections, the last of duplicate keys wins, and no multi-line values.
+class CIni_View {
+public:
+	struct TEntry {
+		std::string_view key;
+		std::string_view value;
+	};
+
+	struct TSection {
+		std::string_view name;
+		std::vector<TEntry> entries;
+
+		//returns a view with nullptr data, if there is no such key
+		std::string_view Find_Value(const std::string_view key) const noexcept;
+		std::string_view Find_Value(const wchar_t *key) const noexcept;	//for the ASCII config names of the descriptors
+	};
+protected:
+	std::vector<TSection> mSections;
+
+	TSection& Section(const std::string_view name);	//finds or appends; invalidates the previously returned references
+public:
+	bool Parse(const char *memory, const size_t len);
+	std::vector<TSection>& Sections() noexcept { return mSections; }
+};
+
+bool Equal_Ignore_Case(const std::string_view a, const std::string_view b) noexcept;
@@ -36,6 +36,7 @@
 
 #include "winapi_mapping.h"
 #include "string_utils.h"
+#include "ConvertUTF.h"
 #include "winapi_mapping.h"
 
 #include <sstream>
@@ -87,6 +88,52 @@ std::wstring Widen_String(const std::string& str) {
     return Widen_Char(str.c_str());
 }
 
+std::wstring Widen_UTF8(const std::string_view str) {
+	std::wstring result(str.size(), L'\0');	//UTF-8 never has fewer bytes than code units
+	if (str.empty())
+		return result;
+
+	const UTF8_t* source = reinterpret_cast<const UTF8_t*>(str.data());
+	ConversionResult rc = sourceIllegal;
+	size_t converted = 0;
+	if constexpr (sizeof(wchar_t) == sizeof(UTF32_t)) {
+		UTF32_t* target = reinterpret_cast<UTF32_t*>(result.data());
+		rc = ConvertUTF8toUTF32(&source, source + str.size(), &target, target + result.size(), lenientConversion);
+		converted = target - reinterpret_cast<UTF32_t*>(result.data());
+	}
+	else {
+		UTF16_t* target = reinterpret_cast<UTF16_t*>(result.data());
+		rc = ConvertUTF8toUTF16(&source, source + str.size(), &target, target + result.size(), lenientConversion);
+		converted = target - reinterpret_cast<UTF16_t*>(result.data());
+	}
+
+	if (rc == conversionOK)
+		result.resize(converted);
+	else
+		std::transform(str.begin(), str.end(), result.begin(), [](const char c) { return static_cast<wchar_t>(static_cast<unsigned char>(c)); });
+
+	return result;
+}
+
+std::string Narrow_UTF8(const std::wstring_view wstr) {
+	std::string result(wstr.size() * 4, '\0');		//a code point takes 4 bytes at most
+	if (wstr.empty())
+		return result;
+
+	UTF8_t* target = reinterpret_cast<UTF8_t*>(result.data());
+	if constexpr (sizeof(wchar_t) == sizeof(UTF32_t)) {
+		const UTF32_t* source = reinterpret_cast<const UTF32_t*>(wstr.data());
+		ConvertUTF32toUTF8(&source, source + wstr.size(), &target, target + result.size(), lenientConversion);
+	}
+	else {
+		const UTF16_t* source = reinterpret_cast<const UTF16_t*>(wstr.data());
+		ConvertUTF16toUTF8(&source, source + wstr.size(), &target, target + result.size(), lenientConversion);
+	}
+
+	result.resize(target - reinterpret_cast<UTF8_t*>(result.data()));
+	return result;
+}
+
 
 std::wstring Lower_String(const std::wstring& wstr) {
     std::wstring result;
@@ -40,6 +40,7 @@
 #include "winapi_mapping.h"
 
 #include <string>
+#include <string_view>
 #include <locale>
 #include <vector>
 
@@ -78,6 +79,8 @@ std::string Narrow_WString(const std::wstring &wstr);
 std::string Narrow_WChar(const wchar_t *wstr);
 std::wstring Widen_Char(const char *str);
 std::wstring Widen_String(const std::string &str);
+std::wstring Widen_UTF8(const std::string_view str);	//text, which is not a valid UTF-8, is widened byte by byte
+std::string Narrow_UTF8(const std::wstring_view wstr);	//invalid code points are replaced
 
 
 inline bool Is_Empty(const std::wstring& wstr) {
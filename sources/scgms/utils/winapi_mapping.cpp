@@ -34,6 +34,9 @@
  *    Volume 177, pp. 354-362, 2020
  */
 #include "winapi_mapping.h"
+#ifdef __cplusplus
+#include "heap_profiler.h"
+#endif
 
 #ifdef FREERTOS
 extern "C"{
@@ -49,9 +52,11 @@ extern "C"{
 #ifdef __cplusplus
 	#include <string>
 	#include <cstdlib>
+	#include <cstdint>
 #else
 	#include <string.h>
 	#include <stdlib.h>
+	#include <stdint.h>
 #endif
 
 EXTERN_C void localtime_s(struct tm* t, const time_t* tim)
@@ -64,17 +69,42 @@ EXTERN_C void gmtime_s(struct tm* t, const time_t* tim)
 	gmtime_r(tim, t);
 }
 
-EXTERN_C void* _aligned_malloc(size_t n, size_t alignment)
+static void* Platform_Aligned_Malloc(size_t n, size_t alignment)
 {
 	void* mem = NULL;
 #if defined(WASM) || defined(ESP32) 
-	mem = malloc(n);
+	if (posix_memalign(&mem, alignment, n) != 0)
+		mem = NULL;
 #elif defined(FREERTOS)
-	mem = pvPortMalloc(n);
+	//pvPortMalloc aligns to portBYTE_ALIGNMENT only => over-allocate and keep the original pointer right below the aligned block
+	void* raw = pvPortMalloc(n + alignment - 1 + sizeof(void*));
+	if (raw != NULL) {
+		const uintptr_t aligned = ((uintptr_t)raw + sizeof(void*) + alignment - 1) & ~((uintptr_t)alignment - 1);
+		((void**)aligned)[-1] = raw;
+		mem = (void*)aligned;
+	}
 #endif
 	return mem;
 }
 
+EXTERN_C void* _aligned_malloc(size_t n, size_t alignment)
+{
+	//as on Windows, the alignment must be a power of two
+	if ((alignment == 0) || ((alignment & (alignment - 1)) != 0))
+		return NULL;
+	if (alignment < sizeof(void*))
+		alignment = sizeof(void*);
+
+#if defined(SCGMS_HEAP_PROFILER)
+	//the profiler keeps its header below the returned memory; skipping a whole multiple of the alignment keeps it aligned
+	const size_t offset = alignment > heap_profiler::Header_Size ? alignment : heap_profiler::Header_Size;
+	void* block = Platform_Aligned_Malloc(n + offset, alignment);
+	return block ? heap_profiler::Track(block, offset, n, heap_profiler::NTag::Containers) : NULL;
+#else
+	return Platform_Aligned_Malloc(n, alignment);
+#endif
+}
+
 #endif
 
 EXTERN_C void* _aligned_malloc_dbg(size_t n, size_t alignment, const char* filename, int line)
@@ -82,13 +112,23 @@ EXTERN_C void* _aligned_malloc_dbg(size_t n, size_t alignment, const char* filen
 	return _aligned_malloc(n, alignment);
 }
 
-EXTERN_C void _aligned_free(void* _Block)
+static void Platform_Aligned_Free(void* _Block)
 {
 #if defined(WASM) || defined(ESP32) 
     free(_Block);
 #elif defined(FREERTOS)
-	vPortFree(_Block);
+	if (_Block != NULL)
+		vPortFree(((void**)_Block)[-1]);
+#endif
+}
+
+EXTERN_C void _aligned_free(void* _Block)
+{
+#if defined(SCGMS_HEAP_PROFILER)
+	if (_Block != NULL)
+		_Block = heap_profiler::Untrack(_Block);
 #endif
+	Platform_Aligned_Free(_Block);
 }
 
 EXTERN_C int getenv_s(size_t *len, char *value, size_t valuesz, const char *name)
@@ -0,0 +1,281 @@
+//Host tool, which compiles a chain configuration ini into a precompiled form for the firmware.
+//It has to be built with the same filters as the firmware, because the parameters are matched against their descriptors.
+//
+//usage: compile_chain [--tables] <config.ini> <output.h>
+//	without --tables, the output header defines config_binary_data and config_binary_size, see SCGMS_BINARY_CHAIN_CONFIG in scgms.cpp
+//	with --tables, it defines the ROM-resident scgms::TChain_Table config_table, see SCGMS_CHAIN_TABLES in scgms.cpp
+
+#include <scgms/rtl/FilterLib.h>
+#include <scgms/rtl/referencedImpl.h>
+#include <scgms/rtl/ChainValidation.h>
+#include <scgms/utils/string_utils.h>
+#include <scgms/src/persistent_chain_configuration.h>
+#include <scgms/src/binary_chain_configuration.h>
+
+#include <cstdio>
+#include <cstring>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <iterator>
+
+static const char* Parameter_Type_Name(const scgms::NParameter_Type type)
+{
+	switch (type)
+	{
+		case scgms::NParameter_Type::ptNull: return "ptNull";
+		case scgms::NParameter_Type::ptWChar_Array: return "ptWChar_Array";
+		case scgms::NParameter_Type::ptInt64_Array: return "ptInt64_Array";
+		case scgms::NParameter_Type::ptDouble: return "ptDouble";
+		case scgms::NParameter_Type::ptRatTime: return "ptRatTime";
+		case scgms::NParameter_Type::ptInt64: return "ptInt64";
+		case scgms::NParameter_Type::ptBool: return "ptBool";
+		case scgms::NParameter_Type::ptSignal_Model_Id: return "ptSignal_Model_Id";
+		case scgms::NParameter_Type::ptDiscrete_Model_Id: return "ptDiscrete_Model_Id";
+		case scgms::NParameter_Type::ptMetric_Id: return "ptMetric_Id";
+		case scgms::NParameter_Type::ptSolver_Id: return "ptSolver_Id";
+		case scgms::NParameter_Type::ptModel_Produced_Signal_Id: return "ptModel_Produced_Signal_Id";
+		case scgms::NParameter_Type::ptSignal_Id: return "ptSignal_Id";
+		case scgms::NParameter_Type::ptDouble_Array: return "ptDouble_Array";
+		case scgms::NParameter_Type::ptSubject_Id: return "ptSubject_Id";
+		default: return nullptr;
+	}
+}
+
+static std::string Wide_Literal(const std::wstring& str)
+{
+	std::ostringstream literal;
+	literal << "L\"";
+	for (const wchar_t wc : str)
+	{
+		if ((wc == L'\\') || (wc == L'"'))
+			literal << '\\' << static_cast<char>(wc);
+		else if ((wc >= 0x20) && (wc < 0x7F))
+			literal << static_cast<char>(wc);
+		else
+			literal << "\\U" << std::hex << std::setw(8) << std::setfill('0') << static_cast<uint32_t>(wc) << std::dec;
+	}
+	literal << "\"";
+	return literal.str();
+}
+
+static std::string Double_Literal(const double value)
+{
+	if (std::isnan(value))
+		return "std::numeric_limits<double>::quiet_NaN()";
+	if (std::isinf(value))
+		return value > 0.0 ? "std::numeric_limits<double>::infinity()" : "-std::numeric_limits<double>::infinity()";
+
+	//hexfloat keeps the exact value
+	std::ostringstream literal;
+	literal << std::hexfloat << value;
+	return literal.str();
+}
+
+static std::string GUID_Literal(const GUID& id)
+{
+	std::ostringstream literal;
+	literal << std::hex << "{ 0x" << id.Data1 << ", 0x" << id.Data2 << ", 0x" << id.Data3 << ", {";
+	for (size_t i = 0; i < sizeof(id.Data4); i++)
+		literal << (i ? ", 0x" : " 0x") << static_cast<unsigned int>(id.Data4[i]);
+	literal << " } }";
+	return literal.str();
+}
+
+static void Write_Binary(std::ostream& header, const std::vector<uint8_t>& binary, const uint64_t source_hash)
+{
+	header << "#include <stdint.h>\n#include <stddef.h>\n\n";
+	header << "static const uint64_t config_binary_source_hash = 0x" << std::hex << source_hash << "ULL;\n";
+	header << "static const uint8_t config_binary_data[] = {";
+	for (size_t i = 0; i < binary.size(); i++)
+		header << ((i % 16) == 0 ? "\n\t" : " ") << "0x" << static_cast<unsigned int>(binary[i]) << ",";
+	header << "\n};\n" << std::dec;
+	header << "static const size_t config_binary_size = sizeof(config_binary_data);\n";
+}
+
+//decodes the just compiled binary into the constexpr tables, so that there is a single compiler of the ini
+static bool Write_Tables(std::ostream& header, const std::vector<uint8_t>& binary)
+{
+	binary_chain::CReader reader{ binary.data(), binary.size() };
+	binary_chain::THeader binary_header;
+	if (!binary_chain::Read_Header(reader, binary_header))
+		return false;
+
+	std::ostringstream arrays, links;
+	for (uint32_t link_idx = 0; link_idx < binary_header.link_count; link_idx++)
+	{
+		const GUID id = reader.Read_GUID();
+		const uint16_t parameter_count = reader.Read_U16();
+
+		std::ostringstream parameters;
+		for (uint16_t param_idx = 0; param_idx < parameter_count; param_idx++)
+		{
+			const uint16_t desc_idx = reader.Read_U16();
+			const scgms::NParameter_Type type = static_cast<scgms::NParameter_Type>(reader.Read_U8());
+			const binary_chain::NValue_Encoding encoding = static_cast<binary_chain::NValue_Encoding>(reader.Read_U8());
+			const char* type_name = Parameter_Type_Name(type);
+			if (!type_name)
+				return false;
+
+			std::string dbl = "0.0", int64 = "0", guid = GUID_Literal(Invalid_GUID), str = "nullptr", dbl_array = "nullptr", int64_array = "nullptr";
+			size_t count = 0;
+			const char* encoding_name = "Value";
+
+			if (encoding != binary_chain::NValue_Encoding::Value)
+			{
+				encoding_name = encoding == binary_chain::NValue_Encoding::Variable ? "Variable" : "Text";
+				str = Wide_Literal(reader.Read_String());
+			}
+			else
+			{
+				const std::string array_name = "link_" + std::to_string(link_idx) + "_parameter_" + std::to_string(param_idx);
+				switch (type)
+				{
+					case scgms::NParameter_Type::ptRatTime:
+					case scgms::NParameter_Type::ptDouble:
+						dbl = Double_Literal(reader.Read_Double());
+						break;
+
+					case scgms::NParameter_Type::ptInt64:
+					case scgms::NParameter_Type::ptSubject_Id:
+						int64 = std::to_string(static_cast<int64_t>(reader.Read_U64())) + "LL";
+						break;
+
+					case scgms::NParameter_Type::ptBool:
+						int64 = std::to_string(reader.Read_U8());
+						break;
+
+					case scgms::NParameter_Type::ptWChar_Array:
+						str = Wide_Literal(reader.Read_String());
+						break;
+
+					case scgms::NParameter_Type::ptDouble_Array:
+						count = reader.Read_U32();
+						if (count > 0)
+						{
+							arrays << "\tconstexpr double " << array_name << "[] = {";
+							for (size_t i = 0; i < count; i++)
+								arrays << (i ? ", " : " ") << Double_Literal(reader.Read_Double());
+							arrays << " };\n";
+							dbl_array = array_name;
+						}
+						break;
+
+					case scgms::NParameter_Type::ptInt64_Array:
+						count = reader.Read_U32();
+						if (count > 0)
+						{
+							arrays << "\tconstexpr int64_t " << array_name << "[] = {";
+							for (size_t i = 0; i < count; i++)
+								arrays << (i ? ", " : " ") << static_cast<int64_t>(reader.Read_U64()) << "LL";
+							arrays << " };\n";
+							int64_array = array_name;
+						}
+						break;
+
+					case scgms::NParameter_Type::ptNull:
+						break;
+
+					default:	//GUID types
+						guid = GUID_Literal(reader.Read_GUID());
+						break;
+				}
+			}
+
+			parameters << "\t\t{ " << desc_idx << ", scgms::NParameter_Type::" << type_name << ", scgms::NParameter_Value_Encoding::" << encoding_name << ", "
+				<< dbl << ", " << int64 << ", " << guid << ", " << str << ", " << dbl_array << ", " << int64_array << ", " << count << " },\n";
+		}
+
+		if (!reader.Valid())
+			return false;
+
+		const std::string parameters_name = "link_" + std::to_string(link_idx) + "_parameters";
+		if (parameter_count > 0)
+			arrays << "\tconstexpr scgms::TParameter_Entry " << parameters_name << "[] = {\n" << parameters.str() << "\t};\n\n";
+
+		links << "\t\t{ " << GUID_Literal(id) << ", " << (parameter_count > 0 ? parameters_name : std::string{ "nullptr" }) << ", " << parameter_count << " },\n";
+	}
+
+	header << "#include <scgms/iface/FilterIface.h>\n#include <limits>\n\n";
+	header << "namespace config_tables {\n" << arrays.str();
+	if (binary_header.link_count > 0)
+		header << "\tconstexpr scgms::TLink_Entry links[] = {\n" << links.str() << "\t};\n";
+	header << "}\n\n";
+	header << "constexpr scgms::TChain_Table config_table = { " << (binary_header.link_count > 0 ? "config_tables::links" : "nullptr") << ", "
+		<< binary_header.link_count << ", 0x" << std::hex << binary_header.source_hash << "ULL };\n" << std::dec;
+
+	return reader.At_End();
+}
+
+int main(int argc, char** argv)
+{
+	const bool tables = (argc == 4) && (strcmp(argv[1], "--tables") == 0);
+	if (argc != (tables ? 4 : 3))
+	{
+		fprintf(stderr, "usage: %s [--tables] <config.ini> <output.h>\n", argv[0]);
+		return 1;
+	}
+	const char* input_path = argv[tables ? 2 : 1];
+	const char* output_path = argv[tables ? 3 : 2];
+
+	std::ifstream input{ input_path, std::ios::binary };
+	if (!input)
+	{
+		fprintf(stderr, "Cannot read %s\n", input_path);
+		return 1;
+	}
+	const std::string ini{ std::istreambuf_iterator<char>{input}, std::istreambuf_iterator<char>{} };
+
+	const size_t malformed_line = scgms::Find_Chain_Ini_Error(ini.c_str());
+	if (malformed_line != 0)
+	{
+		fprintf(stderr, "%s:%zu: malformed line\n", input_path, malformed_line);
+		return 1;
+	}
+
+	refcnt::Swstr_list errors = refcnt::Swstr_list{};
+	scgms::SPersistent_Filter_Chain_Configuration configuration{};
+	if (!configuration)
+	{
+		fprintf(stderr, "Failed to construct SPersistent_Filter_Chain_Configuration\n");
+		return 1;
+	}
+
+	const uint64_t source_hash = binary_chain::Hash_Source(ini.data(), ini.size());
+	HRESULT rc = configuration->Load_From_Memory(ini.data(), ini.size(), errors.get());
+	std::vector<uint8_t> binary;
+	if (rc == S_OK)
+		rc = Compile_Chain_Configuration(configuration.get(), source_hash, binary, errors);
+
+	errors.for_each([](auto str) { fprintf(stderr, "%s\n", Narrow_WString(str).c_str()); });
+	if (rc != S_OK)
+	{
+		fprintf(stderr, "Failed to compile %s\n", input_path);
+		return 1;
+	}
+
+	std::ostringstream header;
+	header << "#pragma once\n";
+	header << "//generated by compile_chain from " << input_path << ", do not edit\n";
+	if (tables)
+	{
+		if (!Write_Tables(header, binary))
+		{
+			fprintf(stderr, "Failed to generate the tables of %s\n", input_path);
+			return 1;
+		}
+	}
+	else
+		Write_Binary(header, binary, source_hash);
+
+	std::ofstream output{ output_path, std::ios::binary };
+	output << header.str();
+	if (!output)
+	{
+		fprintf(stderr, "Cannot write %s\n", output_path);
+		return 1;
+	}
+
+	return 0;
+}